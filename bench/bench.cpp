@@ -0,0 +1,230 @@
+/*
+ * @file bench.cpp
+ * @brief 設定の組み合わせごとに libmimixfe の実時間比、遅延、CPU 時間、最大メモリ使用量を計測するベンチマーク
+ * @author Copyright (C) 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ */
+
+#include <unistd.h>
+#include <syslog.h>
+#include <signal.h>
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "XFERecorder.h"
+#include "XFETypedef.h"
+
+#include "stream_stats.h"
+
+volatile sig_atomic_t xfe_flag_ = 0;
+void xfe_sig_handler_(int signum){ xfe_flag_ = 1; }
+
+/**
+ * @class BenchConfig
+ * @brief ベンチマーク対象の設定の組み合わせ
+ */
+class BenchConfig
+{
+public:
+	mimixfe::XFEECConfig::Preference pref_;
+	mimixfe::XFEBeamformerConfig::type bfType_;
+	bool postfilter_;
+	mimixfe::XFELocalizerConfig::SearchArea area_;
+	int speakers_;
+};
+
+class UserData
+{
+public:
+	explicit UserData(size_t maxSamples) : firstWallNs_(0), firstStreamMs_(0)
+	{
+		// コールバック関数内でメモリ確保が起きないよう、事前に確保しておく
+		lagMs_.reserve(maxSamples);
+	}
+	StreamStats stats_;
+	std::vector<double> lagMs_; //!< コールバックごとの遅延（ストリーム上の時刻に対する到着時刻の遅れ）[ms]
+	int64_t firstWallNs_;
+	unsigned long long firstStreamMs_;
+};
+
+static int64_t monotonicNs()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+void recorderCallback(
+		short* buffer,
+		size_t buflen,
+		mimixfe::SpeechState state,
+		int sourceId,
+		mimixfe::StreamInfo* info,
+		size_t infolen,
+		void* userdata)
+{
+	UserData *p = reinterpret_cast<UserData*>(userdata);
+	StreamStats::Timer timer(p->stats_, info, infolen);
+	if(infolen == 0){
+		return;
+	}
+	const int64_t now = monotonicNs();
+	if(p->firstWallNs_ == 0){
+		p->firstWallNs_ = now;
+		p->firstStreamMs_ = info[0].milliseconds_;
+	}
+	if(p->lagMs_.size() < p->lagMs_.capacity()){
+		const double streamMs = static_cast<double>(info[infolen-1].milliseconds_ + 10 - p->firstStreamMs_);
+		p->lagMs_.push_back((now - p->firstWallNs_) / 1e6 - streamMs);
+	}
+}
+
+static double percentile(const std::vector<double>& sorted, double q)
+{
+	if(sorted.empty()){
+		return 0;
+	}
+	size_t idx = static_cast<size_t>(q * (sorted.size()-1) + 0.5);
+	return sorted[idx];
+}
+
+static const char* prefName(mimixfe::XFEECConfig::Preference pref)
+{
+	switch(pref){
+	case mimixfe::XFEECConfig::Preference::Accurate: return "Accurate";
+	case mimixfe::XFEECConfig::Preference::Balanced: return "Balanced";
+	case mimixfe::XFEECConfig::Preference::Fast: return "Fast";
+	}
+	return "";
+}
+
+/**
+ * @brief 1 つの設定で計測する。子プロセスで実行され、結果の前半（RTF と遅延）を標準出力に書き出す。
+ * @return 終了ステータス
+ */
+static int runOne(const BenchConfig& bc, int seconds)
+{
+	using namespace mimixfe;
+	XFESourceConfig s;
+	XFEECConfig e;
+	e.pref_ = bc.pref_;
+	XFEVADConfig v;
+	XFEBeamformerConfig b;
+	b.type_ = bc.bfType_;
+	b.postfilter_enable_ = bc.postfilter_;
+	XFEDynamicLocalizerConfig c;
+	c.area_ = bc.area_;
+	c.maxSimultaneousSpeakers_ = bc.speakers_;
+	XFEOutputConfig o;
+	o.type_ = XFEOutputConfig::outputType::allFrames; // 遅延を毎フレーム計測するため、音声の有無によらずコールバックさせる
+	o.codec_ = AudioCodec::RAWPCM;
+
+	UserData data(static_cast<size_t>(seconds) * 100 * bc.speakers_ * 2);
+	try{
+		XFERecorder rec(s,e,v,b,c,o,recorderCallback,reinterpret_cast<void*>(&data));
+		rec.setLogLevel(LOG_UPTO(LOG_WARNING));
+		rec.start();
+		for(int i=0;i<seconds && rec.isActive() && xfe_flag_ == 0;++i){
+			sleep(1);
+		}
+		StreamStats::Snapshot st = data.stats_.snapshot();
+		int status = rec.stop();
+		if(status != 0){
+			return status;
+		}
+		std::vector<double> lag(data.lagMs_);
+		std::sort(lag.begin(), lag.end());
+		// 遅延は、計測区間内で最も小さかった遅延を基準とした相対値とする
+		const double base = lag.empty() ? 0 : lag.front();
+		for(size_t i=0;i<lag.size();++i){
+			lag[i] -= base;
+		}
+		printf("%.3f\t%.2f\t%.2f\t%.2f\t%.2f\t%.3f\t%llu\t",
+				st.realTimeFactor_,
+				percentile(lag, 0.50), percentile(lag, 0.95), percentile(lag, 0.99), lag.empty() ? 0 : lag.back(),
+				st.callbackMaxMs_,
+				static_cast<unsigned long long>(st.missingFrames_));
+		fflush(stdout);
+	}catch(const XFERecorderError& e){
+		std::cerr << "XFE Recorder Exception: " << e.what() << "(" << e.errorno() << ")" << std::endl;
+		return 1;
+	}catch(const std::exception& e){
+		std::cerr << "Exception: " << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	if(signal(SIGINT, xfe_sig_handler_) == SIG_ERR){
+		return 1;
+	}
+	using namespace mimixfe;
+	int seconds = 30; // 1 つの設定あたりの計測時間[s]
+	if(argc > 1){
+		seconds = atoi(argv[1]);
+	}
+	if(seconds <= 0){
+		std::cerr << "Usage: " << argv[0] << " [seconds per configuration]" << std::endl;
+		return 1;
+	}
+
+	std::vector<BenchConfig> configs;
+	const XFEECConfig::Preference prefs[] = {XFEECConfig::Preference::Accurate, XFEECConfig::Preference::Balanced, XFEECConfig::Preference::Fast};
+	const XFEBeamformerConfig::type bfTypes[] = {XFEBeamformerConfig::type::MVDR_v1, XFEBeamformerConfig::type::MVDR_v2};
+	const XFELocalizerConfig::SearchArea areas[] = {XFELocalizerConfig::SearchArea::planar, XFELocalizerConfig::SearchArea::sphere};
+	for(auto pref : prefs){
+		for(auto bfType : bfTypes){
+			for(int postfilter=0;postfilter<2;++postfilter){
+				for(auto area : areas){
+					for(int speakers=1;speakers<=4;++speakers){
+						configs.push_back(BenchConfig{pref, bfType, postfilter == 1, area, speakers});
+					}
+				}
+			}
+		}
+	}
+
+	printf("pref\tbf\tpostfilter\tarea\tspeakers\trtf\tlat_p50_ms\tlat_p95_ms\tlat_p99_ms\tlat_max_ms\tcallback_max_ms\tmissing_frames\tcpu_s\tmaxrss_kb\n");
+	fflush(stdout);
+	for(size_t i=0;i<configs.size() && xfe_flag_ == 0;++i){
+		const BenchConfig& bc = configs[i];
+		printf("%s\t%s\t%d\t%s\t%d\t",
+				prefName(bc.pref_),
+				bc.bfType_ == XFEBeamformerConfig::type::MVDR_v1 ? "MVDR_v1" : "MVDR_v2",
+				bc.postfilter_ ? 1 : 0,
+				bc.area_ == XFELocalizerConfig::SearchArea::planar ? "planar" : "sphere",
+				bc.speakers_);
+		fflush(stdout);
+		// 最大メモリ使用量と CPU 時間を設定ごとに独立して計測するため、子プロセスで実行する
+		pid_t pid = fork();
+		if(pid < 0){
+			perror("fork");
+			return 1;
+		}else if(pid == 0){
+			_exit(runOne(bc, seconds));
+		}
+		int status = 0;
+		struct rusage usage;
+		if(wait4(pid, &status, 0, &usage) < 0){
+			perror("wait4");
+			return 1;
+		}
+		if(!WIFEXITED(status) || WEXITSTATUS(status) != 0){
+			printf("failed\n");
+			continue;
+		}
+		const double cpu = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+		printf("%.2f\t%ld\n", cpu, usage.ru_maxrss);
+		fflush(stdout);
+	}
+	return 0;
+}
@@ -0,0 +1,210 @@
+/*
+ * @file block_rebuffer.h
+ * \~english
+ * @brief Re-blocks recorder callbacks into fixed-length blocks of 10 to 200 ms
+ * \~japanese
+ * @brief コールバック関数に与えられる音声を 10ms 〜 200ms の固定長ブロックにまとめ直す
+ * \~
+ * @copyright Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ * @copyright Apache License, Version 2.0
+ *
+ * Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MIMIXFE_EXAMPLES_BLOCK_REBUFFER_H_
+#define MIMIXFE_EXAMPLES_BLOCK_REBUFFER_H_
+
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <stddef.h>
+
+#include "XFETypedef.h"
+
+/**
+ * @class BlockRebuffer
+ * @brief recorderCallback_t として XFERecorder に与え、音源ごとに blockMs ずつの音声と解析結果にまとめ直してからユーザー定義コールバック関数を呼び出す
+ * @details ブロックは原則として blockMs / 10 個の StreamInfo と、それに対応するサンプル数の音声からなる。発話区間と非発話区間は同じブロックに含めないため、以下のブロックは blockMs より短くなる。
+ * - 非発話区間（NonSpeech）の最後のブロック。発話が始まった時点、及び flush() の時点で、ブロックに満たない残りが出力される。
+ * - 発話の最後のブロック（SpeechEnd）。残りがない場合は音声も StreamInfo も含まない（buflen == 0, infolen == 0）。StreamInfo を伴わない音声が残っている場合は、それも全てこのブロックに含まれる。
+ * - 1 ブロックに満たない発話。全体が 1 つの SpeechStart のブロックとして出力され、その後に空の SpeechEnd のブロックが続く。
+ *
+ * SpeechStart はその発話の最初のブロックに、SpeechEnd は最後のブロックにのみ付与される。SpeechEnd がないまま次の SpeechStart が来た場合や flush() の時点で発話中の場合も、残りを SpeechEnd として出力して発話を終える。
+ * XFERecorder::stop() の後に flush() を呼び出して残りを出力すること。blockMs を短くすると遅延が小さくなり、長くするとコールバック関数の呼び出し回数が減る。
+ * 音声のサンプル数と StreamInfo の個数が対応しない呼び出しがあった場合も、発話区間と非発話区間の最後のブロックで残りの音声を全て出力するので、音声が次の区間に持ち越されることはない。
+ * サンプル数が StreamInfo の個数 × 10ms 分と一致しなかったブロックの数は misaligned() で得られる。
+ * 作業領域は再利用されるので、定常状態では StreamInfo の空間スペクトルを含めてメモリ確保は起きない。
+ */
+class BlockRebuffer
+{
+public:
+	/**
+	 * @brief コンストラクタ
+	 * @param [in] callback ブロックごとに呼び出されるユーザー定義コールバック関数
+	 * @param [in] userdata 任意データ
+	 * @param [in] blockMs ブロック長[ms]。10 〜 200 の 10 の倍数。
+	 * @param [in] samplingrate 出力サンプリングレート（XFESourceConfig::samplingrate_）
+	 */
+	BlockRebuffer(mimixfe::recorderCallback_t callback, void* userdata, int blockMs, int samplingrate = 16000) :
+		callback_(callback), userdata_(userdata),
+		blockFrames_(blockMs / frameMs_), samplesPerFrame_(samplingrate / 1000 * frameMs_), misaligned_(0)
+	{
+		if(blockMs < 10 || blockMs > 200 || blockMs % frameMs_ != 0){
+			throw std::invalid_argument("BlockRebuffer: block length must be a multiple of 10 ms in [10,200]");
+		}
+	}
+
+	/**
+	 * @brief XFERecorder に与える recorderCallback_t。userdata には BlockRebuffer へのポインタを与える。
+	 */
+	static void recorderCallback(
+			short* buffer,
+			size_t buflen,
+			mimixfe::SpeechState state,
+			int sourceId,
+			mimixfe::StreamInfo* info,
+			size_t infolen,
+			void* userdata)
+	{
+		reinterpret_cast<BlockRebuffer*>(userdata)->add(buffer, buflen, state, sourceId, info, infolen);
+	}
+
+	/**
+	 * @brief 1 回分の呼び出しを追加し、揃ったブロックを出力する
+	 */
+	void add(const short* buffer, size_t buflen, mimixfe::SpeechState state, int sourceId, const mimixfe::StreamInfo* info, size_t infolen)
+	{
+		Pending& p = pending_[sourceId];
+		const bool speech = state != mimixfe::SpeechState::NonSpeech;
+		// 発話区間と非発話区間は同じブロックに含めない。SpeechEnd がないまま次の発話が始まった場合も、前の発話の残りを先に出力する
+		if(state == mimixfe::SpeechState::SpeechStart || p.speech_ != speech){
+			finish(sourceId, p);
+		}
+		p.speech_ = speech;
+		p.samples_.insert(p.samples_.end(), buffer, buffer + buflen);
+		for(size_t i=0;i<infolen;++i){
+			if(p.numInfos_ < p.infos_.size()){
+				p.infos_[p.numInfos_] = info[i];
+			}else{
+				p.infos_.push_back(info[i]);
+			}
+			p.numInfos_++;
+		}
+
+		if(state == mimixfe::SpeechState::SpeechEnd){
+			finish(sourceId, p);
+		}else{
+			while(p.numInfos_ >= blockFrames_){
+				emit(sourceId, p, blockFrames_, speech ? nextSpeechState(p) : mimixfe::SpeechState::NonSpeech);
+			}
+		}
+	}
+
+	/**
+	 * @brief ブロックに満たない残りを全ての音源について出力する。XFERecorder::stop() の後に呼び出す。
+	 * @details 発話区間の残りは SpeechEnd として、非発話区間の残りは NonSpeech として出力される。
+	 */
+	void flush()
+	{
+		for(auto& it : pending_){
+			finish(it.first, it.second);
+		}
+	}
+
+	/**
+	 * @brief 音声のサンプル数が StreamInfo の個数に対応しなかった出力ブロックの数
+	 */
+	size_t misaligned() const { return misaligned_; }
+
+private:
+	static const int frameMs_ = 10; //!< StreamInfo 1 つあたりの長さ[ms]
+
+	class Pending
+	{
+	public:
+		Pending() : numInfos_(0), speech_(false), started_(false) {}
+		std::vector<short> samples_;
+		std::vector<mimixfe::StreamInfo> infos_; //!< 先頭 numInfos_ 個が有効。要素を再利用して空間スペクトルの再確保を避ける
+		size_t numInfos_;
+		bool speech_;  //!< 発話区間のデータであるか
+		bool started_; //!< 発話の最初のブロックを出力済で、SpeechEnd を出力していないか
+	};
+
+	BlockRebuffer(const BlockRebuffer&) = delete;
+	BlockRebuffer& operator=(const BlockRebuffer&) = delete;
+
+	/**
+	 * @brief 残りを全て出力する。発話区間の場合は最後のブロックに SpeechEnd を付与して発話を終える
+	 */
+	void finish(int sourceId, Pending& p)
+	{
+		if(!p.speech_){
+			if(p.numInfos_ != 0 || !p.samples_.empty()){
+				emit(sourceId, p, p.numInfos_, mimixfe::SpeechState::NonSpeech, true);
+			}
+			return;
+		}
+		while(p.numInfos_ > blockFrames_){
+			emit(sourceId, p, blockFrames_, nextSpeechState(p));
+		}
+		if(!p.started_){
+			if(p.numInfos_ == 0 && p.samples_.empty()){
+				return; // 出力中の発話はない
+			}
+			// 1 ブロックに満たない発話の場合も SpeechStart を出力する
+			emit(sourceId, p, p.numInfos_, nextSpeechState(p));
+		}
+		emit(sourceId, p, p.numInfos_, mimixfe::SpeechState::SpeechEnd, true);
+		p.started_ = false;
+	}
+
+	mimixfe::SpeechState nextSpeechState(Pending& p)
+	{
+		if(p.started_){
+			return mimixfe::SpeechState::InSpeech;
+		}
+		p.started_ = true;
+		return mimixfe::SpeechState::SpeechStart;
+	}
+
+	/**
+	 * @brief 先頭 frames 個の StreamInfo と対応する音声を出力し、作業領域から取り除く
+	 * @param [in] last 区間の最後のブロックであるか。true の場合は StreamInfo の個数に関わらず残りの音声を全て出力する
+	 */
+	void emit(int sourceId, Pending& p, size_t frames, mimixfe::SpeechState state, bool last = false)
+	{
+		const size_t expected = frames * samplesPerFrame_;
+		const size_t samples = last ? p.samples_.size() : std::min(p.samples_.size(), expected);
+		if(samples != expected){
+			misaligned_++;
+		}
+		callback_(p.samples_.data(), samples, state, sourceId, p.infos_.data(), frames, userdata_);
+		p.samples_.erase(p.samples_.begin(), p.samples_.begin() + samples);
+		for(size_t i=frames;i<p.numInfos_;++i){
+			std::swap(p.infos_[i-frames], p.infos_[i]);
+		}
+		p.numInfos_ -= frames;
+	}
+
+	const mimixfe::recorderCallback_t callback_;
+	void* const userdata_;
+	const size_t blockFrames_;     //!< 1 ブロックの StreamInfo の個数
+	const size_t samplesPerFrame_; //!< StreamInfo 1 つあたりのサンプル数
+	size_t misaligned_;            //!< サンプル数が StreamInfo の個数に対応しなかった出力ブロックの数
+	std::map<int, Pending> pending_;
+};
+
+#endif /* MIMIXFE_EXAMPLES_BLOCK_REBUFFER_H_ */
@@ -0,0 +1,120 @@
+/*
+ * @file ex10.cpp
+ * @brief ex4.cpp 動的方向複数音源抽出サンプルを一部変更し、同じ時間区間の全音源を 1 回のコールバック関数呼び出しでまとめて受け取る例。
+ * @author Copyright (C) 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ */
+#include <unistd.h>
+#include <syslog.h>
+#include <sched.h>
+#include <signal.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <map>
+#include <iomanip>
+
+#include "XFERecorder.h"
+#include "XFETypedef.h"
+
+#include "source_batcher.h"
+
+volatile sig_atomic_t xfe_flag_ = 0;
+void xfe_sig_handler_(int signum){ xfe_flag_ = 1; }
+
+class UserData
+{
+public:
+	~UserData()
+	{
+		for(auto& f : files_){
+			fclose(f.second);
+		}
+	}
+	FILE* file(int sourceId)
+	{
+		auto it = files_.find(sourceId);
+		if(it != files_.end()){
+			return it->second;
+		}
+		std::stringstream filename;
+		filename << "/tmp/ex10_" << sourceId << ".raw";
+		FILE* f = fopen(filename.str().c_str(), "w");
+		files_[sourceId] = f;
+		return f;
+	}
+	std::map<int, FILE*> files_; //!< 音源番号ごとの音声ファイル
+};
+
+void batchCallback(const SourceBatch& batch, void* userdata)
+{
+	UserData *p = reinterpret_cast<UserData*>(userdata);
+	// 解析結果は項目ごとに全音源分が連続しているので、全音源の平均発話存在確率を 1 つのループで計算できる
+	float probability = 0;
+	for(size_t k=0;k<batch.totalFrames_;++k){
+		probability += batch.speechProbability_[k];
+	}
+	if(batch.totalFrames_ != 0){
+		probability /= batch.totalFrames_;
+	}
+	std::cout << "sources=" << batch.numSources_ << " frames=" << batch.totalFrames_
+			<< std::fixed << std::setprecision(3) << " mean probability=" << probability*100.0F << "[%]";
+	for(size_t i=0;i<batch.numSources_;++i){
+		std::cout << " [ID=" << batch.sourceId_[i];
+		if(batch.numFrames_[i] != 0){
+			std::cout << " azimuth=" << batch.azimuth_[batch.frameOffset_[i]];
+		}
+		std::cout << "]";
+		if(batch.audioLen_[i] != 0){
+			fwrite(batch.audio_[i], sizeof(short), batch.audioLen_[i], p->file(batch.sourceId_[i]));
+		}
+	}
+	std::cout << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	if(signal(SIGINT, xfe_sig_handler_) == SIG_ERR){
+		return 1;
+	}
+	using namespace mimixfe;
+	XFESourceConfig s;
+
+	XFEECConfig e;
+	XFEVADConfig v;
+	XFEBeamformerConfig b;
+	XFEDynamicLocalizerConfig c;
+	c.maxSimultaneousSpeakers_ = 2;
+	XFEOutputConfig o;
+	UserData data;
+	SourceBatcher batcher(batchCallback, reinterpret_cast<void*>(&data));
+	int return_status = 0;
+	try{
+		XFERecorder rec(s,e,v,b,c,o,SourceBatcher::recorderCallback,reinterpret_cast<void*>(&batcher));
+		rec.setLogLevel(LOG_UPTO(LOG_DEBUG)); // デバッグレベルのログから出力する
+		rec.start();
+		int countup = 0;
+		int timeout = 120;
+		while(rec.isActive()){
+			std::cout << countup++  << " / " << timeout << std::endl;
+			if(countup == timeout){
+				break;
+			}
+			if(xfe_flag_ == 1){
+				break;
+			}
+			sleep(1);
+		}
+		return_status = rec.stop();
+	}catch(const XFERecorderError& e){
+		std::cerr << "XFE Recorder Exception: " << e.what() << "(" << e.errorno() << ")" << std::endl;
+	}catch(const std::exception& e){
+		std::cerr << "Exception: " << e.what() << std::endl;
+	}
+	batcher.flush(); // 録音停止後に、まとめられていない残りを出力する
+	if(return_status != 0){
+		std::cerr << "Abort by error code = " << return_status << std::endl;
+	}else{
+		std::cout << "Normally finished" << std::endl;
+	}
+	return return_status;
+}
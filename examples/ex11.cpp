@@ -0,0 +1,120 @@
+/*
+ * @file ex11.cpp
+ * @brief ex1.cpp 固定方向単一音源サンプルを一部変更し、コールバック関数が呼ばれる単位を 10ms 〜 200ms の固定長ブロックに揃える例。
+ * @author Copyright (C) 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ */
+
+#include <iostream>
+#include <unistd.h>
+#include <syslog.h>
+#include <sched.h>
+#include <signal.h>
+#include <string>
+#include <iomanip>
+#include <stdlib.h>
+#include "XFERecorder.h"
+#include "XFETypedef.h"
+
+#include "block_rebuffer.h"
+
+volatile sig_atomic_t xfe_flag_ = 0;
+void xfe_sig_handler_(int signum){ xfe_flag_ = 1; }
+
+class UserData
+{
+public:
+	FILE *file_;
+};
+
+void recorderCallback(
+		short* buffer,
+		size_t buflen,
+		mimixfe::SpeechState state,
+		int sourceId,
+		mimixfe::StreamInfo* info,
+		size_t infolen,
+		void* userdata)
+{
+	std::string s = "";
+	if(state == mimixfe::SpeechState::SpeechStart){
+		s = "Speech Start";
+	}else if(state == mimixfe::SpeechState::InSpeech){
+		s = "In Speech";
+	}else if(state == mimixfe::SpeechState::SpeechEnd){
+		s = "End of Speech";
+	}else if(state == mimixfe::SpeechState::NonSpeech){
+		s = "Non Speech";
+	}
+  UserData *p = reinterpret_cast<UserData*>(userdata);
+  if(buflen != 0){
+	  fwrite(buffer, sizeof(short), buflen, p->file_);
+  }
+
+  // 画面表示で確認（ブロックの先頭時刻と長さのみ）
+  std::cout << "State: " << s << " / sourceId=" << sourceId << " / " << buflen << " samples, " << infolen << " frames";
+  if(infolen != 0){
+	  std::cout << " from " << info[0].milliseconds_ << "[ms]";
+  }
+  std::cout << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	if(signal(SIGINT, xfe_sig_handler_) == SIG_ERR){
+		return 1;
+	}
+	int blockMs = 200; // アーカイブ用途では長く、バージイン等の低遅延用途では短くする
+	if(argc > 1){
+		blockMs = atoi(argv[1]);
+	}
+	using namespace mimixfe;
+	XFESourceConfig s;
+
+	XFEECConfig e;
+	XFEVADConfig v;
+	XFEBeamformerConfig b;
+	XFEStaticLocalizerConfig c({Direction(270, 90)});
+	XFEOutputConfig o;
+
+	UserData data1;
+	data1.file_ = fopen("/tmp/ex11.raw","w");
+
+	int return_status = 0;
+	try{
+		// recorderCallback は blockMs ごとに呼ばれるようになる
+		BlockRebuffer rebuffer(recorderCallback, reinterpret_cast<void*>(&data1), blockMs);
+		XFERecorder rec(s,e,v,b,c,o,BlockRebuffer::recorderCallback,reinterpret_cast<void*>(&rebuffer));
+		rec.setLogLevel(LOG_UPTO(LOG_DEBUG)); // デバッグレベルのログから出力する
+		rec.start();
+		int countup = 0;
+		int timeout = 10;
+		while(rec.isActive()){
+			std::cout << countup++  << " / " << timeout << std::endl;
+			if(countup == timeout){
+				rec.stop();
+				break;
+			}
+			if(xfe_flag_ == 1){
+				rec.stop();
+				break;
+			}
+			sleep(1);
+		}
+		return_status = rec.stop();
+		rebuffer.flush(); // 録音停止後に、ブロックに満たない残りを出力する
+		if(rebuffer.misaligned() != 0){
+			std::cerr << "Blocks with audio not matching StreamInfo: " << rebuffer.misaligned() << std::endl;
+		}
+	 }catch(const XFERecorderError& e){
+		std::cerr << "XFE Recorder Exception: " << e.what() << "(" << e.errorno() << ")" << std::endl;
+	 }catch(const std::exception& e){
+		std::cerr << "Exception: " << e.what() << std::endl;
+	 }
+	 if(return_status != 0){
+		 std::cerr << "Abort by error code = " << return_status << std::endl;
+	 }else{
+		 std::cout << "Normally finished" << std::endl;
+	 }
+	 fclose(data1.file_);
+	 return return_status;
+}
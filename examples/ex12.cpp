@@ -0,0 +1,155 @@
+/*
+ * @file ex12.cpp
+ * @brief ex1.cpp 固定方向単一音源サンプルを一部変更し、外部からのトリガー（SIGUSR1）を受けた時点から遡って直近の抽出音声と 16ch エコーキャンセル済音声を取り出す例。
+ * @author Copyright (C) 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ */
+
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+#include <syslog.h>
+#include <sched.h>
+#include <signal.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "XFERecorder.h"
+#include "XFETypedef.h"
+
+#include "preroll_buffer.h"
+
+volatile sig_atomic_t xfe_flag_ = 0;
+void xfe_sig_handler_(int signum){ xfe_flag_ = 1; }
+
+volatile sig_atomic_t xfe_trigger_ = 0;
+void xfe_trigger_handler_(int signum){ xfe_trigger_ = 1; }
+
+/**
+ * @brief 抽出音声のリングバッファ。StreamInfo の経過時間に合わせて書き込み、モニタリング音声と同じ時間軸に揃える。
+ */
+class ProcessedPreroll
+{
+public:
+	explicit ProcessedPreroll(int maxSeconds) : buffer_(1, maxSeconds), started_(false), originMs_(0) {}
+	PrerollBuffer buffer_;
+	bool started_;
+	unsigned long long originMs_; //!< 最初の StreamInfo の経過時間[ms]
+};
+
+void recorderCallback(
+		short* buffer,
+		size_t buflen,
+		mimixfe::SpeechState state,
+		int sourceId,
+		mimixfe::StreamInfo* info,
+		size_t infolen,
+		void* userdata)
+{
+	ProcessedPreroll *p = reinterpret_cast<ProcessedPreroll*>(userdata);
+	if(infolen == 0){
+		p->buffer_.write(buffer, buflen);
+		return;
+	}
+	if(!p->started_){
+		p->started_ = true;
+		p->originMs_ = info[0].milliseconds_;
+	}
+	// allFrames では非発話区間は音声なし（buflen == 0）で呼び出されるので、その区間を無音で埋める
+	const uint64_t samplesPerMs = 16;
+	const uint64_t end = (info[infolen-1].milliseconds_ + 10 - p->originMs_) * samplesPerMs;
+	const uint64_t written = p->buffer_.written();
+	// 最初の StreamInfo より前の音声は時間軸に載らないので捨てる
+	const uint64_t lead = buflen > end ? buflen - end : 0;
+	buffer += lead;
+	buflen -= lead;
+	const uint64_t begin = end - buflen;
+	if(begin > written){
+		p->buffer_.writeSilence(begin - written);
+	}
+	// 発話開始時のヘッドパディングは、非発話区間として既に無音で埋めた区間と重なるので、その無音を音声で書き換える
+	const uint64_t overlap = written > begin ? std::min<uint64_t>(written - begin, buflen) : 0;
+	p->buffer_.overwrite(begin, buffer, overlap);
+	p->buffer_.write(buffer + overlap, buflen - overlap);
+}
+
+/**
+ * @brief 直近 seconds 秒分の音声をファイルに書き出す
+ */
+void dump(const PrerollBuffer& preroll, double seconds, const std::string& name, int count)
+{
+	std::vector<short> audio;
+	const size_t frames = preroll.read(audio, seconds);
+	std::stringstream filename;
+	filename << "/tmp/ex12_" << name << "_" << count << ".raw";
+	FILE* file = fopen(filename.str().c_str(), "w");
+	if(file == nullptr){
+		return;
+	}
+	fwrite(audio.data(), sizeof(short), audio.size(), file);
+	fclose(file);
+	std::cout << filename.str() << ": " << frames << " frames x " << preroll.channels() << " ch" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	if(signal(SIGINT, xfe_sig_handler_) == SIG_ERR){
+		return 1;
+	}
+	// ボタン押下やウェイクワード検出などの外部トリガーの代わりに、kill -USR1 <pid> で取り出す
+	if(signal(SIGUSR1, xfe_trigger_handler_) == SIG_ERR){
+		return 1;
+	}
+	using namespace mimixfe;
+	XFESourceConfig s;
+
+	XFEECConfig e;
+	XFEVADConfig v;
+	XFEBeamformerConfig b;
+	XFEStaticLocalizerConfig c({Direction(270, 90)});
+	XFEOutputConfig o;
+	o.type_ = XFEOutputConfig::outputType::allFrames; // 非発話区間の経過時間も受け取り、無音で埋めて時間を揃える
+
+	const int maxSeconds = 10;  // 保持する長さ[s]
+	const double seconds = 5.0; // トリガー時に取り出す長さ[s]
+	ProcessedPreroll processed(maxSeconds);
+	PrerollBuffer ec(16, maxSeconds);
+
+	int return_status = 0;
+	try{
+		XFERecorder rec(s,e,v,b,c,o,recorderCallback,reinterpret_cast<void*>(&processed));
+		rec.setLogLevel(LOG_UPTO(LOG_DEBUG)); // デバッグレベルのログから出力する
+		rec.addMonitoringCallback(PrerollBuffer::monitoringCallback, MonitoringAudioType::S16kC16EC, AudioCodec::RAWPCM, reinterpret_cast<void*>(&ec));
+		rec.start();
+		std::cout << "kill -USR1 " << getpid() << " to dump the last " << seconds << " seconds" << std::endl;
+		int countup = 0;
+		int timeout = 120;
+		int triggers = 0;
+		while(rec.isActive()){
+			if(xfe_trigger_ == 1){
+				xfe_trigger_ = 0;
+				dump(processed.buffer_, seconds, "processed", triggers);
+				dump(ec, seconds, "ec16", triggers);
+				triggers++;
+			}
+			std::cout << countup++  << " / " << timeout << std::endl;
+			if(countup == timeout){
+				break;
+			}
+			if(xfe_flag_ == 1){
+				break;
+			}
+			sleep(1);
+		}
+		return_status = rec.stop();
+	}catch(const XFERecorderError& e){
+		std::cerr << "XFE Recorder Exception: " << e.what() << "(" << e.errorno() << ")" << std::endl;
+	}catch(const std::exception& e){
+		std::cerr << "Exception: " << e.what() << std::endl;
+	}
+	if(return_status != 0){
+		std::cerr << "Abort by error code = " << return_status << std::endl;
+	}else{
+		std::cout << "Normally finished" << std::endl;
+	}
+	return return_status;
+}
@@ -0,0 +1,120 @@
+/*
+ * @file ex13.cpp
+ * @brief ex1.cpp 固定方向単一音源サンプルを一部変更し、キーワードが検出された発話のみをコールバック関数で受け取る例。
+ * @author Copyright (C) 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ */
+
+#include <iostream>
+#include <unistd.h>
+#include <syslog.h>
+#include <sched.h>
+#include <signal.h>
+#include <string>
+#include <cmath>
+#include "XFERecorder.h"
+#include "XFETypedef.h"
+
+#include "keyword_gate.h"
+
+volatile sig_atomic_t xfe_flag_ = 0;
+void xfe_sig_handler_(int signum){ xfe_flag_ = 1; }
+
+class UserData
+{
+public:
+	FILE *file_;
+};
+
+/**
+ * @brief キーワード検出器の代わりに、音量が閾値を超えた時点で検出したものとする。実際にはキーワード検出エンジンをここで呼び出す。
+ */
+bool keywordDetector(
+		const short* buffer,
+		size_t buflen,
+		mimixfe::SpeechState state,
+		int sourceId,
+		void* userdata)
+{
+	if(buflen == 0){
+		return false;
+	}
+	double power = 0;
+	for(size_t i=0;i<buflen;++i){
+		power += static_cast<double>(buffer[i]) * buffer[i];
+	}
+	const double rms = std::sqrt(power / buflen) / 32768.0;
+	return rms > 0 && 20.0 * std::log10(rms) > *reinterpret_cast<double*>(userdata);
+}
+
+void recorderCallback(
+		short* buffer,
+		size_t buflen,
+		mimixfe::SpeechState state,
+		int sourceId,
+		mimixfe::StreamInfo* info,
+		size_t infolen,
+		void* userdata)
+{
+	// キーワードが検出された発話のみが与えられる
+	if(state == mimixfe::SpeechState::SpeechStart){
+		std::cout << "Speech Start (keyword detected)" << std::endl;
+	}else if(state == mimixfe::SpeechState::SpeechEnd){
+		std::cout << "End of Speech" << std::endl;
+	}
+	UserData *p = reinterpret_cast<UserData*>(userdata);
+	if(buflen != 0){
+		fwrite(buffer, sizeof(short), buflen, p->file_);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if(signal(SIGINT, xfe_sig_handler_) == SIG_ERR){
+		return 1;
+	}
+	using namespace mimixfe;
+	XFESourceConfig s;
+
+	XFEECConfig e;
+	XFEVADConfig v;
+	XFEBeamformerConfig b;
+	XFEStaticLocalizerConfig c({Direction(270, 90)});
+	XFEOutputConfig o;
+
+	UserData data;
+	data.file_ = fopen("/tmp/ex13.raw","w");
+	double threshold = -20.0; // 検出とみなす音量[dbFS]
+	// キーワードは発話の先頭 2 秒以内に検出されるものとし、検出された発話の終わりから 5 秒以内に始まった発話も出力する
+	KeywordGate gate(recorderCallback, reinterpret_cast<void*>(&data), keywordDetector, reinterpret_cast<void*>(&threshold), 2000, 5000, 16000, v.headPaddingTime_, v.tailPaddingTime_);
+
+	int return_status = 0;
+	try{
+		XFERecorder rec(s,e,v,b,c,o,KeywordGate::recorderCallback,reinterpret_cast<void*>(&gate));
+		rec.setLogLevel(LOG_UPTO(LOG_DEBUG)); // デバッグレベルのログから出力する
+		rec.start();
+		int countup = 0;
+		int timeout = 60;
+		while(rec.isActive()){
+			std::cout << countup++  << " / " << timeout << " accepted=" << gate.accepted() << " rejected=" << gate.rejected() << std::endl;
+			if(countup == timeout){
+				break;
+			}
+			if(xfe_flag_ == 1){
+				break;
+			}
+			sleep(1);
+		}
+		return_status = rec.stop();
+	}catch(const XFERecorderError& e){
+		std::cerr << "XFE Recorder Exception: " << e.what() << "(" << e.errorno() << ")" << std::endl;
+	}catch(const std::exception& e){
+		std::cerr << "Exception: " << e.what() << std::endl;
+	}
+	if(return_status != 0){
+		std::cerr << "Abort by error code = " << return_status << std::endl;
+	}else{
+		std::cout << "Normally finished" << std::endl;
+	}
+	fclose(data.file_);
+	return return_status;
+}
@@ -0,0 +1,117 @@
+/*
+ * @file ex14.cpp
+ * @brief ex1.cpp 固定方向単一音源サンプルを一部変更し、抽出された音声を 8kHz と 48kHz に変換して保存する例。
+ * @author Copyright (C) 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ */
+
+#include <iostream>
+#include <unistd.h>
+#include <syslog.h>
+#include <sched.h>
+#include <signal.h>
+#include <string>
+#include <vector>
+#include "XFERecorder.h"
+#include "XFETypedef.h"
+
+#include "resampler.h"
+
+volatile sig_atomic_t xfe_flag_ = 0;
+void xfe_sig_handler_(int signum){ xfe_flag_ = 1; }
+
+class UserData
+{
+public:
+	UserData() : narrowband_(16000, 8000), fullband_(16000, 48000)
+	{
+		narrowbandFile_ = fopen("/tmp/ex14_8k.raw","w");
+		fullbandFile_ = fopen("/tmp/ex14_48k.raw","w");
+	}
+	~UserData()
+	{
+		fclose(narrowbandFile_);
+		fclose(fullbandFile_);
+	}
+	PolyphaseResampler narrowband_; //!< 16kHz から 8kHz（電話網向け）
+	PolyphaseResampler fullband_;   //!< 16kHz から 48kHz（録音向け）
+	std::vector<short> buffer_;     //!< 変換結果の作業領域
+	FILE* narrowbandFile_;
+	FILE* fullbandFile_;
+};
+
+void write(PolyphaseResampler& resampler, const short* buffer, size_t buflen, bool end, std::vector<short>& work, FILE* file)
+{
+	work.clear();
+	resampler.process(buffer, buflen, work);
+	if(end){
+		// 発話の終わりでフィルタに残っている音声を出力し、次の発話とは独立に変換する
+		resampler.flush(work);
+	}
+	fwrite(work.data(), sizeof(short), work.size(), file);
+}
+
+void recorderCallback(
+		short* buffer,
+		size_t buflen,
+		mimixfe::SpeechState state,
+		int sourceId,
+		mimixfe::StreamInfo* info,
+		size_t infolen,
+		void* userdata)
+{
+	if(state == mimixfe::SpeechState::SpeechStart){
+		std::cout << "Speech Start" << std::endl;
+	}else if(state == mimixfe::SpeechState::SpeechEnd){
+		std::cout << "End of Speech" << std::endl;
+	}
+	UserData *p = reinterpret_cast<UserData*>(userdata);
+	const bool end = state == mimixfe::SpeechState::SpeechEnd;
+	write(p->narrowband_, buffer, buflen, end, p->buffer_, p->narrowbandFile_);
+	write(p->fullband_, buffer, buflen, end, p->buffer_, p->fullbandFile_);
+}
+
+int main(int argc, char** argv)
+{
+	if(signal(SIGINT, xfe_sig_handler_) == SIG_ERR){
+		return 1;
+	}
+	using namespace mimixfe;
+	XFESourceConfig s;
+
+	XFEECConfig e;
+	XFEVADConfig v;
+	XFEBeamformerConfig b;
+	XFEStaticLocalizerConfig c({Direction(270, 90)});
+	XFEOutputConfig o;
+
+	UserData data;
+	int return_status = 0;
+	try{
+		XFERecorder rec(s,e,v,b,c,o,recorderCallback,reinterpret_cast<void*>(&data));
+		rec.setLogLevel(LOG_UPTO(LOG_DEBUG)); // デバッグレベルのログから出力する
+		rec.start();
+		int countup = 0;
+		int timeout = 20;
+		while(rec.isActive()){
+			std::cout << countup++  << " / " << timeout << std::endl;
+			if(countup == timeout){
+				break;
+			}
+			if(xfe_flag_ == 1){
+				break;
+			}
+			sleep(1);
+		}
+		return_status = rec.stop();
+	}catch(const XFERecorderError& e){
+		std::cerr << "XFE Recorder Exception: " << e.what() << "(" << e.errorno() << ")" << std::endl;
+	}catch(const std::exception& e){
+		std::cerr << "Exception: " << e.what() << std::endl;
+	}
+	if(return_status != 0){
+		std::cerr << "Abort by error code = " << return_status << std::endl;
+	}else{
+		std::cout << "Normally finished" << std::endl;
+	}
+	return return_status;
+}
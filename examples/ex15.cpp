@@ -0,0 +1,127 @@
+/*
+ * @file ex15.cpp
+ * @brief ex1.cpp 固定方向単一音源サンプルを一部変更し、libmimixfe のスレッドとコールバック関数を呼び出すスレッドの CPU 割り当てと優先度を設定する例。
+ * @author Copyright (C) 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ */
+
+#include <iostream>
+#include <unistd.h>
+#include <syslog.h>
+#include <sched.h>
+#include <signal.h>
+#include <string.h>
+#include <string>
+#include "XFERecorder.h"
+#include "XFETypedef.h"
+
+#include "thread_config.h"
+
+volatile sig_atomic_t xfe_flag_ = 0;
+void xfe_sig_handler_(int signum){ xfe_flag_ = 1; }
+
+class UserData
+{
+public:
+	explicit UserData(const ThreadConfig& config) : callbackThread_(config) {}
+	CallbackThreadConfig callbackThread_;
+	FILE *file_;
+};
+
+void recorderCallback(
+		short* buffer,
+		size_t buflen,
+		mimixfe::SpeechState state,
+		int sourceId,
+		mimixfe::StreamInfo* info,
+		size_t infolen,
+		void* userdata)
+{
+	UserData *p = reinterpret_cast<UserData*>(userdata);
+	// コールバック関数を呼び出している信号処理スレッドに、初回の呼び出しで設定を適用する
+	p->callbackThread_.apply();
+	if(buflen != 0){
+		fwrite(buffer, sizeof(short), buflen, p->file_);
+	}
+}
+
+std::string describe(const ThreadConfigResult& r)
+{
+	std::string s = r.honored() ? "honored" : "not honored";
+	if(r.affinityError_ > 0){
+		s += std::string(" (affinity: ") + strerror(r.affinityError_) + ")";
+	}
+	if(r.schedulingError_ > 0){
+		s += std::string(" (scheduling: ") + strerror(r.schedulingError_) + ")";
+	}
+	return s;
+}
+
+int main(int argc, char** argv)
+{
+	if(signal(SIGINT, xfe_sig_handler_) == SIG_ERR){
+		return 1;
+	}
+	using namespace mimixfe;
+	XFESourceConfig s;
+
+	XFEECConfig e;
+	XFEVADConfig v;
+	XFEBeamformerConfig b;
+	XFEStaticLocalizerConfig c({Direction(270, 90)});
+	XFEOutputConfig o;
+
+	// libmimixfe が生成するスレッドは CPU 2, 3 で SCHED_FIFO の優先度 40 とする
+	ThreadConfig library;
+	library.cpus_ = {2, 3};
+	library.changeScheduling_ = true;
+	library.policy_ = SCHED_FIFO;
+	library.priority_ = 40;
+	// コールバック関数を呼び出す信号処理スレッドは CPU 3 に固定し、優先度を 50 とする
+	ThreadConfig callback = library;
+	callback.cpus_ = {3};
+	callback.priority_ = 50;
+	// メインスレッド（ネットワーククライアント等）は CPU 0, 1 とする
+	ThreadConfig application;
+	application.cpus_ = {0, 1};
+
+	UserData data(callback);
+	data.file_ = fopen("/tmp/ex15.raw","w");
+	int return_status = 0;
+	try{
+		ScopedThreadConfig scope(library);
+		XFERecorder rec(s,e,v,b,c,o,recorderCallback,reinterpret_cast<void*>(&data));
+		rec.setLogLevel(LOG_UPTO(LOG_DEBUG)); // デバッグレベルのログから出力する
+		rec.start();
+		scope.restore(); // ここまでに生成されたスレッドに設定が引き継がれる
+		std::cout << "library threads: " << describe(scope.result()) << std::endl;
+		std::cout << "main thread: " << describe(applyThreadConfig(application)) << std::endl;
+		int countup = 0;
+		int timeout = 20;
+		while(rec.isActive()){
+			std::cout << countup++  << " / " << timeout;
+			if(data.callbackThread_.applied()){
+				std::cout << " callback thread: " << describe(data.callbackThread_.result());
+			}
+			std::cout << std::endl;
+			if(countup == timeout){
+				break;
+			}
+			if(xfe_flag_ == 1){
+				break;
+			}
+			sleep(1);
+		}
+		return_status = rec.stop();
+	}catch(const XFERecorderError& e){
+		std::cerr << "XFE Recorder Exception: " << e.what() << "(" << e.errorno() << ")" << std::endl;
+	}catch(const std::exception& e){
+		std::cerr << "Exception: " << e.what() << std::endl;
+	}
+	if(return_status != 0){
+		std::cerr << "Abort by error code = " << return_status << std::endl;
+	}else{
+		std::cout << "Normally finished" << std::endl;
+	}
+	fclose(data.file_);
+	return return_status;
+}
@@ -0,0 +1,186 @@
+/*
+ * @file ex7.cpp
+ * @brief ex3.cpp 動的方向単一音源抽出サンプルを一部変更し、コールバック関数内で重い処理を行わず、ロックフリーキューを経由して別スレッドで音声を処理する例。
+ * @author Copyright (C) 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ */
+
+#include <unistd.h>
+#include <syslog.h>
+#include <sched.h>
+#include <signal.h>
+#include <string.h>
+#include <iostream>
+#include <string>
+#include <iomanip>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+#include "XFERecorder.h"
+#include "XFETypedef.h"
+
+#include "spsc_queue.h"
+#include "stream_info_pod.h"
+#include "stream_stats.h"
+
+volatile sig_atomic_t xfe_flag_ = 0;
+void xfe_sig_handler_(int signum){ xfe_flag_ = 1; }
+
+/**
+ * @class AudioChunk
+ * @brief キューの 1 要素。コールバック関数の 1 回の呼び出しで与えられる音声は、最大 100ms 分ずつに分割して格納される。
+ */
+class AudioChunk
+{
+public:
+	static const size_t maxSamples_ = 1600; //!< 16kHz で 100ms
+	static const size_t maxInfos_ = 10;     //!< 10ms ごとの解析結果 100ms 分
+	short buffer_[maxSamples_];
+	size_t buflen_;
+	mimixfe::SpeechState state_;
+	int sourceId_;
+	StreamInfoPOD info_[maxInfos_];
+	size_t infolen_;
+};
+const size_t AudioChunk::maxSamples_;
+const size_t AudioChunk::maxInfos_;
+
+class UserData
+{
+public:
+	UserData() : queue_(64, OverflowPolicy::DropOldest), file_(nullptr),
+		offeredSamples_(0), offeredFrames_(0), consumedSamples_(0), consumedFrames_(0) {}
+	SPSCQueue<AudioChunk> queue_; //!< 約 6.4 秒分の音声と解析結果を保持できる
+	AudioChunk chunk_;            //!< コールバック関数内で要素を組み立てるための作業領域
+	StreamStats stats_;           //!< コールバック関数の処理時間、実時間比の集計
+	FILE *file_;
+	// キューの dropped() は要素数なので、破棄された音声の長さは積んだ量と取り出した量の差から求める
+	uint64_t offeredSamples_;     //!< キューに積もうとしたサンプル数（コールバック関数のスレッドのみが更新する）
+	uint64_t offeredFrames_;      //!< キューに積もうとした解析結果のフレーム数
+	uint64_t consumedSamples_;    //!< キューから取り出したサンプル数（消費者スレッドのみが更新する）
+	uint64_t consumedFrames_;     //!< キューから取り出した解析結果のフレーム数
+};
+
+void recorderCallback(
+		short* buffer,
+		size_t buflen,
+		mimixfe::SpeechState state,
+		int sourceId,
+		mimixfe::StreamInfo* info,
+		size_t infolen,
+		void* userdata)
+{
+	// このコールバック関数は libmimixfe の信号処理スレッドから呼ばれるので、ファイル書き込みや画面表示は行わず、コピーしてキューに積むだけとする
+	UserData *p = reinterpret_cast<UserData*>(userdata);
+	StreamStats::Timer timer(p->stats_, info, infolen);
+	AudioChunk& c = p->chunk_;
+	size_t offset = 0;
+	size_t infoOffset = 0;
+	bool first = true;
+	do{
+		c.buflen_ = std::min(buflen - offset, AudioChunk::maxSamples_);
+		memcpy(c.buffer_, buffer + offset, c.buflen_ * sizeof(short));
+		c.infolen_ = std::min(infolen - infoOffset, AudioChunk::maxInfos_);
+		for(size_t i=0;i<c.infolen_;++i){
+			toStreamInfoPOD(info[infoOffset+i], c.info_[i]);
+		}
+		offset += c.buflen_;
+		infoOffset += c.infolen_;
+		const bool last = offset == buflen && infoOffset == infolen;
+		// 分割した場合、SpeechStart は先頭の要素のみ、SpeechEnd は末尾の要素のみに付与する
+		c.state_ = state;
+		if((state == mimixfe::SpeechState::SpeechStart && !first) ||
+		   (state == mimixfe::SpeechState::SpeechEnd && !last)){
+			c.state_ = mimixfe::SpeechState::InSpeech;
+		}
+		c.sourceId_ = sourceId;
+		p->offeredSamples_ += c.buflen_;
+		p->offeredFrames_ += c.infolen_;
+		p->queue_.push(c);
+		first = false;
+	}while(offset < buflen || infoOffset < infolen);
+}
+
+/**
+ * @brief キューから音声を取り出して処理する消費者スレッド。ここでの処理が遅延しても信号処理は停止しない。
+ */
+void consumer(UserData* p)
+{
+	AudioChunk c;
+	while(!p->queue_.closed() || p->queue_.size() != 0){
+		if(!p->queue_.pop(c, std::chrono::milliseconds(100))){
+			continue;
+		}
+		p->consumedSamples_ += c.buflen_;
+		p->consumedFrames_ += c.infolen_;
+		if(c.buflen_ != 0){
+			fwrite(c.buffer_, sizeof(short), c.buflen_, p->file_);
+		}
+		for(size_t i=0;i<c.infolen_;++i){
+			std::cout << c.info_[i].milliseconds_ << "[ms] " <<
+					std::fixed << std::setprecision(3)
+					<< c.info_[i].rmsDbfs_ << "[dbFS] " << c.info_[i].speechProbability_*100.0F << "[%] "
+					<< c.sourceId_ << " angle=" << c.info_[i].angle_ << ", azimuth=" << c.info_[i].azimuth_ << ", peak=" << c.info_[i].spatialSpectralPeak_ << std::endl;
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if(signal(SIGINT, xfe_sig_handler_) == SIG_ERR){
+		return 1;
+	}
+	using namespace mimixfe;
+	XFESourceConfig s;
+
+	XFEECConfig e;
+	XFEVADConfig v;
+	XFEBeamformerConfig b;
+	XFEDynamicLocalizerConfig c;
+	XFEOutputConfig o;
+	o.type_ = XFEOutputConfig::outputType::allFrames; // 実時間比と遅延を求めるため、非発話区間もコールバックさせる
+	UserData data;
+	data.file_ = fopen("/tmp/ex7.raw","w");
+	std::thread consumerThread(consumer, &data);
+	int return_status = 0;
+	try{
+		XFERecorder rec(s,e,v,b,c,o,recorderCallback,reinterpret_cast<void*>(&data));
+		rec.setLogLevel(LOG_UPTO(LOG_DEBUG)); // デバッグレベルのログから出力する
+		rec.start();
+		int countup = 0;
+		int timeout = 120;
+		while(rec.isActive()){
+			StreamStats::Snapshot st = data.stats_.snapshot();
+			std::cout << countup++  << " / " << timeout << " queued=" << data.queue_.size() << ", dropped=" << data.queue_.dropped() << "[chunks]"
+					<< ", RTF=" << st.realTimeFactor_ << ", lag=" << st.lagMs_ << "[ms], callback=" << st.callbackRecentMs_ << "/" << st.callbackMaxMs_ << "[ms]"
+					<< ", missing=" << st.missingFrames_ << std::endl;
+			if(countup == timeout){
+				rec.stop();
+				break;
+			}
+			if(xfe_flag_ == 1){
+				rec.stop();
+				break;
+			}
+			sleep(1);
+		}
+		return_status = rec.stop();
+	}catch(const XFERecorderError& e){
+		std::cerr << "XFE Recorder Exception: " << e.what() << "(" << e.errorno() << ")" << std::endl;
+	}catch(const std::exception& e){
+		std::cerr << "Exception: " << e.what() << std::endl;
+	}
+	data.queue_.close();
+	consumerThread.join();
+	// 録音停止後、消費者スレッドがキューを空にしてから集計するので、差が破棄された量と一致する
+	const uint64_t droppedSamples = data.offeredSamples_ - data.consumedSamples_;
+	std::cout << "pushed=" << data.queue_.pushed() << "[chunks], dropped=" << data.queue_.dropped() << "[chunks] = "
+			<< data.offeredFrames_ - data.consumedFrames_ << "[frames], " << droppedSamples * 1000 / 16000 << "[ms]" << std::endl;
+	if(return_status != 0){
+		std::cerr << "Abort by error code = " << return_status << std::endl;
+	}else{
+		std::cout << "Normally finished" << std::endl;
+	}
+	fclose(data.file_);
+	return return_status;
+}
@@ -0,0 +1,171 @@
+/*
+ * @file ex8.cpp
+ * @brief ex1.cpp 固定方向単一音源サンプルを一部変更し、抽出された発話単位の音声とモニタリング音声を、ワーカースレッドで FLAC もしくは Opus に逐次圧縮して保存する例。
+ * @author Copyright (C) 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ */
+
+#include <iostream>
+#include <sstream>
+#include <memory>
+#include <stdint.h>
+#include <unistd.h>
+#include <syslog.h>
+#include <sched.h>
+#include <signal.h>
+#include <string>
+#include "XFERecorder.h"
+#include "XFETypedef.h"
+
+#include "flac_encoder.h"
+#include "opus_encoder.h"
+
+volatile sig_atomic_t xfe_flag_ = 0;
+void xfe_sig_handler_(int signum){ xfe_flag_ = 1; }
+
+/**
+ * @class EncodedFile
+ * @brief 圧縮済音声をストリームごとに別ファイルに書き出す。実際の利用では、ここでサーバーに送信する。
+ * @details Opus の場合はコンテナに格納されないパケットが与えられるので、パケットごとに 2 バイトのパケット長（リトルエンディアン）を前置して書き出す。
+ */
+class EncodedFile
+{
+public:
+	EncodedFile(const std::string& prefix, const std::string& suffix, bool packetized) :
+		prefix_(prefix), suffix_(suffix), packetized_(packetized), streamId_(-1), file_(nullptr) {}
+	~EncodedFile(){ if(file_ != nullptr) fclose(file_); }
+	void write(const unsigned char* data, size_t len, int streamId)
+	{
+		if(streamId != streamId_){
+			if(file_ != nullptr){
+				fclose(file_);
+			}
+			std::stringstream filename;
+			filename << prefix_ << streamId << suffix_;
+			file_ = fopen(filename.str().c_str(), "w");
+			streamId_ = streamId;
+			if(file_ == nullptr){
+				// 同じ streamId の残りのデータは書き出さずに捨てる
+				std::cerr << "Failed to open " << filename.str() << std::endl;
+			}
+		}
+		if(file_ == nullptr){
+			return;
+		}
+		if(packetized_){
+			const unsigned char header[2] = {static_cast<unsigned char>(len & 0xff), static_cast<unsigned char>(len >> 8)};
+			fwrite(header, 1, sizeof(header), file_);
+		}
+		fwrite(data, 1, len, file_);
+	}
+private:
+	std::string prefix_;
+	std::string suffix_;
+	bool packetized_;
+	int streamId_;
+	FILE *file_;
+};
+
+void encodedCallback(const unsigned char* data, size_t len, int streamId, void* userdata)
+{
+	// ワーカースレッドから呼ばれるので、ここでの処理が遅延しても信号処理は停止しない
+	EncodedFile *p = reinterpret_cast<EncodedFile*>(userdata);
+	p->write(data, len, streamId);
+}
+
+void recorderCallback(
+		short* buffer,
+		size_t buflen,
+		mimixfe::SpeechState state,
+		int sourceId,
+		mimixfe::StreamInfo* info,
+		size_t infolen,
+		void* userdata)
+{
+	// 発話単位でストリームを分ける
+	StreamEncoder *encoder = reinterpret_cast<StreamEncoder*>(userdata);
+	if(state == mimixfe::SpeechState::SpeechStart){
+		encoder->beginStream();
+	}
+	if(buflen != 0){
+		encoder->write(buffer, buflen);
+	}
+	if(state == mimixfe::SpeechState::SpeechEnd){
+		encoder->endStream();
+	}
+}
+
+void monitoringCallback(const short* buffer, size_t buflen, void* userdata)
+{
+	StreamEncoder *encoder = reinterpret_cast<StreamEncoder*>(userdata);
+	encoder->write(buffer, buflen);
+}
+
+int main(int argc, char** argv)
+{
+	if(signal(SIGINT, xfe_sig_handler_) == SIG_ERR){
+		return 1;
+	}
+	const std::string codec = argc > 1 ? argv[1] : "flac";
+	if(codec != "flac" && codec != "opus"){
+		std::cerr << "Usage: " << argv[0] << " [flac|opus]" << std::endl;
+		return 1;
+	}
+	const bool opus = codec == "opus";
+	using namespace mimixfe;
+	XFESourceConfig s;
+
+	XFEECConfig e;
+	XFEVADConfig v;
+	XFEBeamformerConfig b;
+	XFEStaticLocalizerConfig c({Direction(270, 90)});
+	XFEOutputConfig o;
+	o.codec_ = AudioCodec::RAWPCM; // 圧縮はユーザー側のワーカースレッドで行う
+
+	int return_status = 0;
+	try{
+		const std::string suffix = opus ? ".opus.raw" : ".flac";
+		EncodedFile utterances("/tmp/ex8_", suffix, opus);
+		EncodedFile monitor("/tmp/monitor_ex8_", suffix, opus);
+		std::unique_ptr<StreamEncoder> utteranceEncoder;
+		std::unique_ptr<StreamEncoder> monitorEncoder;
+		if(opus){
+			// 24kbps, 20ms フレームごとに Opus パケットが出力される
+			utteranceEncoder.reset(new OpusStreamEncoder(encodedCallback, reinterpret_cast<void*>(&utterances), 24000, 20, 5));
+			monitorEncoder.reset(new OpusStreamEncoder(encodedCallback, reinterpret_cast<void*>(&monitor), 24000, 20, 5));
+		}else{
+			// ブロックサイズ 1600 サンプル（16kHz で 100ms）ごとに圧縮済音声が出力される
+			utteranceEncoder.reset(new FlacStreamEncoder(encodedCallback, reinterpret_cast<void*>(&utterances), 1600));
+			monitorEncoder.reset(new FlacStreamEncoder(encodedCallback, reinterpret_cast<void*>(&monitor), 1600));
+		}
+
+		XFERecorder rec(s,e,v,b,c,o,recorderCallback,reinterpret_cast<void*>(utteranceEncoder.get()));
+		rec.setLogLevel(LOG_UPTO(LOG_DEBUG)); // デバッグレベルのログから出力する
+		rec.addMonitoringCallback(monitoringCallback, MonitoringAudioType::S16kC1EC, AudioCodec::RAWPCM, reinterpret_cast<void*>(monitorEncoder.get()));
+		rec.start();
+		int countup = 0;
+		int timeout = 30;
+		while(rec.isActive()){
+			std::cout << countup++  << " / " << timeout << " dropped=" << utteranceEncoder->dropped() << "/" << monitorEncoder->dropped()
+					<< " errors=" << utteranceEncoder->errors() << "/" << monitorEncoder->errors()
+					<< " closeErrors=" << utteranceEncoder->closeErrors() << "/" << monitorEncoder->closeErrors() << std::endl;
+			if(countup == timeout){
+				break;
+			}
+			if(xfe_flag_ == 1){
+				break;
+			}
+			sleep(1);
+		}
+		return_status = rec.stop();
+	}catch(const XFERecorderError& e){
+		std::cerr << "XFE Recorder Exception: " << e.what() << "(" << e.errorno() << ")" << std::endl;
+	}catch(const std::exception& e){
+		std::cerr << "Exception: " << e.what() << std::endl;
+	}
+	if(return_status != 0){
+		std::cerr << "Abort by error code = " << return_status << std::endl;
+	}else{
+		std::cout << "Normally finished" << std::endl;
+	}
+	return return_status;
+}
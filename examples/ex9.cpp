@@ -0,0 +1,132 @@
+/*
+ * @file ex9.cpp
+ * @brief ex1.cpp 固定方向単一音源サンプルを一部変更し、同じ種類のモニタリング音声を複数の購読者で共有し、動作中に購読者を追加・削除する例。
+ * @author Copyright (C) 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ */
+
+#include <iostream>
+#include <unistd.h>
+#include <syslog.h>
+#include <sched.h>
+#include <signal.h>
+#include <string>
+#include <iomanip>
+#include <atomic>
+#include <cmath>
+#include "XFERecorder.h"
+#include "XFETypedef.h"
+
+#include "monitoring_hub.h"
+
+volatile sig_atomic_t xfe_flag_ = 0;
+void xfe_sig_handler_(int signum){ xfe_flag_ = 1; }
+
+class LevelMeter
+{
+public:
+	LevelMeter() : dbfs_(-96.0F) {}
+	std::atomic<float> dbfs_; //!< 直近のバッファの平均音量[dbfs]
+};
+
+void recorderCallback(
+		short* buffer,
+		size_t buflen,
+		mimixfe::SpeechState state,
+		int sourceId,
+		mimixfe::StreamInfo* info,
+		size_t infolen,
+		void* userdata)
+{
+	if(state == mimixfe::SpeechState::SpeechStart){
+		std::cout << "Speech Start" << std::endl;
+	}else if(state == mimixfe::SpeechState::SpeechEnd){
+		std::cout << "End of Speech" << std::endl;
+	}
+}
+
+/**
+ * @brief 購読者 1: モニタリング音声をファイルに記録する
+ */
+void recordingSubscriber(const short* buffer, size_t buflen, void* userdata)
+{
+	fwrite(buffer, sizeof(short), buflen, reinterpret_cast<FILE*>(userdata));
+}
+
+/**
+ * @brief 購読者 2: モニタリング音声の音量を計算する。購読者 1 と同じバッファが与えられるので、書き換えてはならない。
+ */
+void levelSubscriber(const short* buffer, size_t buflen, void* userdata)
+{
+	if(buflen == 0){
+		return;
+	}
+	double power = 0;
+	for(size_t i=0;i<buflen;++i){
+		power += static_cast<double>(buffer[i]) * buffer[i];
+	}
+	const double rms = std::sqrt(power / buflen) / 32768.0;
+	reinterpret_cast<LevelMeter*>(userdata)->dbfs_ = rms > 0 ? 20.0 * std::log10(rms) : -96.0;
+}
+
+int main(int argc, char** argv)
+{
+	if(signal(SIGINT, xfe_sig_handler_) == SIG_ERR){
+		return 1;
+	}
+	using namespace mimixfe;
+	XFESourceConfig s;
+
+	XFEECConfig e;
+	XFEVADConfig v;
+	XFEBeamformerConfig b;
+	XFEStaticLocalizerConfig c({Direction(270, 90)});
+	XFEOutputConfig o;
+
+	FILE* file = fopen("/tmp/monitor_ex9.raw","w");
+	LevelMeter meter;
+
+	int return_status = 0;
+	try{
+		XFERecorder rec(s,e,v,b,c,o,recorderCallback,nullptr);
+		rec.setLogLevel(LOG_UPTO(LOG_DEBUG)); // デバッグレベルのログから出力する
+		MonitoringHub hub(rec);
+		hub.subscribe(MonitoringAudioType::S16kC1EC, recordingSubscriber, reinterpret_cast<void*>(file)); // 各種類の最初の購読者は start() の前に追加する
+		rec.start();
+		int countup = 0;
+		int timeout = 20;
+		int levelId = -1;
+		while(rec.isActive()){
+			// 5 秒後に 2 つ目の購読者を追加し、15 秒後に削除する。libmimixfe に登録されるモニタリングコールバックは 1 つのままである。
+			if(countup == 5){
+				levelId = hub.subscribe(MonitoringAudioType::S16kC1EC, levelSubscriber, reinterpret_cast<void*>(&meter));
+			}else if(countup == 15){
+				hub.unsubscribe(levelId);
+				levelId = -1;
+			}
+			std::cout << countup++  << " / " << timeout;
+			if(levelId >= 0){
+				std::cout << " " << std::fixed << std::setprecision(1) << meter.dbfs_.load() << "[dbFS]";
+			}
+			std::cout << std::endl;
+			if(countup == timeout){
+				break;
+			}
+			if(xfe_flag_ == 1){
+				break;
+			}
+			sleep(1);
+		}
+		return_status = rec.stop();
+	}catch(const XFERecorderError& e){
+		std::cerr << "XFE Recorder Exception: " << e.what() << "(" << e.errorno() << ")" << std::endl;
+	}catch(const std::exception& e){
+		std::cerr << "Exception: " << e.what() << std::endl;
+	}
+	if(return_status != 0){
+		std::cerr << "Abort by error code = " << return_status << std::endl;
+	}else{
+		std::cout << "Normally finished" << std::endl;
+	}
+	fclose(file);
+	return return_status;
+}
@@ -0,0 +1,116 @@
+/*
+ * @file flac_encoder.h
+ * \~english
+ * @brief Streaming FLAC encoder running on a worker thread
+ * \~japanese
+ * @brief ワーカースレッドで動作するストリーミング FLAC エンコーダ
+ * \~
+ * @copyright Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ * @copyright Apache License, Version 2.0
+ *
+ * Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MIMIXFE_EXAMPLES_FLAC_ENCODER_H_
+#define MIMIXFE_EXAMPLES_FLAC_ENCODER_H_
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <FLAC/stream_encoder.h>
+
+#include "stream_encoder.h"
+
+/**
+ * @class FlacStreamEncoder
+ * @brief 16bit PCM を、ワーカースレッドで逐次 FLAC に圧縮する
+ * @details FLAC フレームはブロックサイズ分のサンプルが揃った時点で出力されるので、遅延はブロックサイズで決まる。ストリームの先頭ではストリームヘッダが出力される。
+ */
+class FlacStreamEncoder : public StreamEncoder
+{
+public:
+	/**
+	 * @brief コンストラクタ
+	 * @param [in] callback 圧縮済音声を受け取るコールバック関数。ワーカースレッドから呼ばれる。
+	 * @param [in] userdata 任意データ
+	 * @param [in] blocksize FLAC のブロックサイズ[サンプル]。16kHz で 1600 の場合、最大遅延は 100ms となる。
+	 * @param [in] samplingrate サンプリングレート
+	 * @param [in] channels チャネル数 [1,8]
+	 * @param [in] compressionLevel 圧縮レベル [0,8]
+	 */
+	FlacStreamEncoder(encodedCallback_t callback, void* userdata,
+			unsigned blocksize = 1600, unsigned samplingrate = 16000, unsigned channels = 1, unsigned compressionLevel = 5) :
+		StreamEncoder(callback, userdata, channels),
+		blocksize_(blocksize), samplingrate_(samplingrate), compressionLevel_(compressionLevel),
+		pcm_(Chunk::maxSamples_), encoder_(nullptr)
+	{
+		if(channels_ == 0 || channels_ > 8){ // FLAC の制約により最大 8 チャネル
+			throw std::invalid_argument("FlacStreamEncoder: unsupported number of channels");
+		}
+		startWorker();
+	}
+
+	~FlacStreamEncoder(){ stopWorker(); }
+
+private:
+	static FLAC__StreamEncoderWriteStatus writeCallback(const FLAC__StreamEncoder* encoder,
+			const FLAC__byte buffer[], size_t bytes, unsigned samples, unsigned currentFrame, void* clientData)
+	{
+		reinterpret_cast<FlacStreamEncoder*>(clientData)->emit(buffer, bytes);
+		return FLAC__STREAM_ENCODER_WRITE_STATUS_OK;
+	}
+
+	bool openStream() override
+	{
+		encoder_ = FLAC__stream_encoder_new();
+		if(encoder_ == nullptr){
+			return false;
+		}
+		const bool configured = FLAC__stream_encoder_set_channels(encoder_, channels_) &&
+				FLAC__stream_encoder_set_bits_per_sample(encoder_, 16) &&
+				FLAC__stream_encoder_set_sample_rate(encoder_, samplingrate_) &&
+				FLAC__stream_encoder_set_compression_level(encoder_, compressionLevel_) &&
+				FLAC__stream_encoder_set_blocksize(encoder_, blocksize_) &&
+				FLAC__stream_encoder_set_streamable_subset(encoder_, blocksize_ <= 4608);
+		// シークできない出力先に逐次出力するので、seek, tell コールバックは与えない
+		if(!configured || FLAC__stream_encoder_init_stream(encoder_, writeCallback, nullptr, nullptr, nullptr, this) != FLAC__STREAM_ENCODER_INIT_STATUS_OK){
+			FLAC__stream_encoder_delete(encoder_);
+			encoder_ = nullptr;
+			return false;
+		}
+		return true;
+	}
+
+	bool closeStream() override
+	{
+		const bool ok = FLAC__stream_encoder_finish(encoder_);
+		FLAC__stream_encoder_delete(encoder_);
+		encoder_ = nullptr;
+		return ok;
+	}
+
+	bool encode(const short* buffer, size_t len) override
+	{
+		std::copy(buffer, buffer + len, pcm_.begin());
+		return FLAC__stream_encoder_process_interleaved(encoder_, pcm_.data(), len / channels_);
+	}
+
+	const unsigned blocksize_;
+	const unsigned samplingrate_;
+	const unsigned compressionLevel_;
+	std::vector<FLAC__int32> pcm_; //!< libFLAC に与えるための 32bit 整数の作業領域
+	FLAC__StreamEncoder* encoder_;
+};
+
+#endif /* MIMIXFE_EXAMPLES_FLAC_ENCODER_H_ */
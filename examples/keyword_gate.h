@@ -0,0 +1,215 @@
+/*
+ * @file keyword_gate.h
+ * \~english
+ * @brief Gates recorder callbacks with a user-supplied keyword detector
+ * \~japanese
+ * @brief ユーザー定義のキーワード検出器によって、コールバック関数に発話を渡すかどうかを決める
+ * \~
+ * @copyright Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ * @copyright Apache License, Version 2.0
+ *
+ * Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MIMIXFE_EXAMPLES_KEYWORD_GATE_H_
+#define MIMIXFE_EXAMPLES_KEYWORD_GATE_H_
+
+#include <map>
+#include <vector>
+#include <atomic>
+#include <stdexcept>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "XFETypedef.h"
+
+/**
+ * @brief キーワード検出器。発話区間の音声が先頭から順に与えられ、キーワードを検出した時点で true を返す。
+ * @details state が SpeechStart の呼び出しで新しい発話が始まるので、検出器の内部状態はそこで初期化すること。
+ */
+using keywordDetector_t = bool (*)(
+		const short* buffer,
+		size_t buflen,
+		mimixfe::SpeechState state,
+		int sourceId,
+		void* userdata);
+
+/**
+ * @class KeywordGate
+ * @brief recorderCallback_t として XFERecorder に与え、キーワードが検出された発話のみをユーザー定義コールバック関数に渡す
+ * @details 発話区間の音声と解析結果は、キーワードが検出されるまで音源ごとに保留され、検出された時点でまとめて SpeechStart として出力される。以降はその発話の終わりまでそのまま出力される。
+ * キーワードが検出されないまま発話が終わった場合、もしくは保留した長さが maxPendingMs を超えた場合、その発話は破棄される。
+ * holdMs を与えると、キーワードが検出された発話の終わりから holdMs 以内に始まった発話は、検出器を呼び出さずに出力される（「キーワード」の後に間をおいて話されたコマンド等）。
+ * 発話区間は XFEVADConfig の headPaddingTime_, tailPaddingTime_ だけ延長されて出力されるので、holdMs はそれらを除いた発話の終わりから次の発話の始まりまでの間隔と比較する。
+ * 非発話区間（XFEOutputConfig::outputType::allFrames の場合）はそのまま出力される。検出器はコールバック関数と同じ信号処理スレッドから呼び出されるので、重い処理は避けること。
+ */
+class KeywordGate
+{
+public:
+	/**
+	 * @brief コンストラクタ
+	 * @param [in] callback キーワードが検出された発話を受け取るユーザー定義コールバック関数
+	 * @param [in] userdata callback に与える任意データ
+	 * @param [in] detector キーワード検出器
+	 * @param [in] detectorUserdata detector に与える任意データ
+	 * @param [in] maxPendingMs キーワードの検出を待つ最大の長さ[ms]
+	 * @param [in] holdMs キーワード検出後、検出器を呼び出さずに発話を出力する時間[ms]
+	 * @param [in] samplingrate 出力サンプリングレート（XFESourceConfig::samplingrate_）
+	 * @param [in] headPaddingMs 発話区間先頭側の延長[ms]（XFEVADConfig::headPaddingTime_）
+	 * @param [in] tailPaddingMs 発話区間末尾側の延長[ms]（XFEVADConfig::tailPaddingTime_）
+	 */
+	KeywordGate(mimixfe::recorderCallback_t callback, void* userdata, keywordDetector_t detector, void* detectorUserdata,
+			int maxPendingMs = 3000, int holdMs = 0, int samplingrate = 16000, int headPaddingMs = 400, int tailPaddingMs = 400) :
+		callback_(callback), userdata_(userdata), detector_(detector), detectorUserdata_(detectorUserdata),
+		maxPendingSamples_(static_cast<size_t>(maxPendingMs) * samplingrate / 1000), holdMs_(holdMs),
+		headPaddingMs_(headPaddingMs), tailPaddingMs_(tailPaddingMs),
+		holdUntilMs_(0), holding_(false), accepted_(0), rejected_(0)
+	{
+		if(detector == nullptr || maxPendingMs <= 0 || holdMs < 0 || headPaddingMs < 0 || tailPaddingMs < 0){
+			throw std::invalid_argument("KeywordGate: detector must be given and lengths must not be negative");
+		}
+	}
+
+	/**
+	 * @brief XFERecorder に与える recorderCallback_t。userdata には KeywordGate へのポインタを与える。
+	 */
+	static void recorderCallback(
+			short* buffer,
+			size_t buflen,
+			mimixfe::SpeechState state,
+			int sourceId,
+			mimixfe::StreamInfo* info,
+			size_t infolen,
+			void* userdata)
+	{
+		reinterpret_cast<KeywordGate*>(userdata)->add(buffer, buflen, state, sourceId, info, infolen);
+	}
+
+	/**
+	 * @brief 1 回分の呼び出しを追加する
+	 */
+	void add(short* buffer, size_t buflen, mimixfe::SpeechState state, int sourceId, mimixfe::StreamInfo* info, size_t infolen)
+	{
+		if(state == mimixfe::SpeechState::NonSpeech){
+			callback_(buffer, buflen, state, sourceId, info, infolen, userdata_);
+			return;
+		}
+		Utterance& u = utterances_[sourceId];
+		if(state == mimixfe::SpeechState::SpeechStart){
+			u.clear();
+			// 先頭側の延長を除いた発話の始まりで比較する
+			if(holding_ && infolen != 0 && info[0].milliseconds_ + headPaddingMs_ <= holdUntilMs_){
+				u.gate_ = Gate::Open;
+				accepted_++;
+			}
+		}
+
+		if(u.gate_ == Gate::Open){
+			callback_(buffer, buflen, state, sourceId, info, infolen, userdata_);
+		}else if(u.gate_ == Gate::Pending){
+			u.samples_.insert(u.samples_.end(), buffer, buffer + buflen);
+			for(size_t i=0;i<infolen;++i){
+				if(u.numInfos_ < u.infos_.size()){
+					u.infos_[u.numInfos_] = info[i];
+				}else{
+					u.infos_.push_back(info[i]);
+				}
+				u.numInfos_++;
+			}
+			if(detector_(buffer, buflen, state, sourceId, detectorUserdata_)){
+				// 保留していた分をまとめて発話の先頭として出力する
+				u.gate_ = Gate::Open;
+				accepted_++;
+				callback_(u.samples_.data(), u.samples_.size(), mimixfe::SpeechState::SpeechStart, sourceId, u.infos_.data(), u.numInfos_, userdata_);
+				u.release();
+				if(state == mimixfe::SpeechState::SpeechEnd){
+					// 検出が発話の最後の呼び出しであった場合も SpeechEnd を出力する
+					callback_(u.samples_.data(), 0, mimixfe::SpeechState::SpeechEnd, sourceId, u.infos_.data(), 0, userdata_);
+				}
+			}else if(state == mimixfe::SpeechState::SpeechEnd || u.samples_.size() > maxPendingSamples_){
+				u.gate_ = Gate::Closed;
+				rejected_++;
+				u.release();
+			}
+		}
+
+		if(state == mimixfe::SpeechState::SpeechEnd){
+			if(u.gate_ == Gate::Open && infolen != 0){
+				// 末尾側の延長を除いた発話の終わりから holdMs 以内とする
+				const unsigned long long endMs = info[infolen-1].milliseconds_;
+				const unsigned long long tailMs = static_cast<unsigned long long>(tailPaddingMs_);
+				holding_ = holdMs_ > 0;
+				holdUntilMs_ = (endMs > tailMs ? endMs - tailMs : 0) + holdMs_;
+			}
+			u.clear();
+		}
+	}
+
+	/**
+	 * @brief キーワードが検出された（もしくは holdMs 以内に始まった）発話の数
+	 */
+	uint64_t accepted() const { return accepted_.load(); }
+
+	/**
+	 * @brief キーワードが検出されずに破棄された発話の数
+	 */
+	uint64_t rejected() const { return rejected_.load(); }
+
+private:
+	enum class Gate
+	{
+		Pending, //!< キーワードの検出待ち
+		Open,    //!< 出力中
+		Closed,  //!< 破棄中
+	};
+
+	class Utterance
+	{
+	public:
+		Utterance() : gate_(Gate::Pending), numInfos_(0) {}
+		void clear()
+		{
+			gate_ = Gate::Pending;
+			release();
+		}
+		void release()
+		{
+			samples_.clear();
+			numInfos_ = 0;
+		}
+		Gate gate_;
+		std::vector<short> samples_;
+		std::vector<mimixfe::StreamInfo> infos_; //!< 先頭 numInfos_ 個が有効。要素を再利用して空間スペクトルの再確保を避ける
+		size_t numInfos_;
+	};
+
+	KeywordGate(const KeywordGate&) = delete;
+	KeywordGate& operator=(const KeywordGate&) = delete;
+
+	const mimixfe::recorderCallback_t callback_;
+	void* const userdata_;
+	const keywordDetector_t detector_;
+	void* const detectorUserdata_;
+	const size_t maxPendingSamples_; //!< 保留する最大サンプル数
+	const int holdMs_;
+	const int headPaddingMs_;
+	const int tailPaddingMs_;
+	unsigned long long holdUntilMs_; //!< この経過時間[ms]までに始まった発話は検出器を呼び出さずに出力する
+	bool holding_;
+	std::map<int, Utterance> utterances_;
+	std::atomic<uint64_t> accepted_;
+	std::atomic<uint64_t> rejected_;
+};
+
+#endif /* MIMIXFE_EXAMPLES_KEYWORD_GATE_H_ */
@@ -0,0 +1,178 @@
+/*
+ * @file monitoring_hub.h
+ * \~english
+ * @brief Shares one monitoring tap per MonitoringAudioType among many subscribers
+ * \~japanese
+ * @brief MonitoringAudioType ごとに 1 つのモニタリングコールバックを複数の購読者で共有する
+ * \~
+ * @copyright Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ * @copyright Apache License, Version 2.0
+ *
+ * Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MIMIXFE_EXAMPLES_MONITORING_HUB_H_
+#define MIMIXFE_EXAMPLES_MONITORING_HUB_H_
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include "XFERecorder.h"
+#include "XFETypedef.h"
+
+/**
+ * @class MonitoringHub
+ * @brief XFERecorder::addMonitoringCallback() を MonitoringAudioType ごとに高々 1 回だけ呼び出し、得られた音声を全ての購読者に同じバッファのまま与える
+ * @details libmimixfe にモニタリングコールバックを登録するのは、その種類の最初の購読者が現れたときのみであり、登録はこのオブジェクトが破棄されるまで維持される（購読者がいない間は何もしない）。
+ * XFERecorder::addMonitoringCallback(), delMonitoringCallback() は録音中に呼び出してよいとはされていないので、各種類の最初の購読者は XFERecorder::start() の前に追加すること。
+ * 録音中に追加しようとした場合、その種類がまだ登録されていなければ subscribe() は失敗する。動作中に購読者を入れ替える種類は、start() の前に一度 subscribe() しておけばよい（直後に unsubscribe() しても登録は残る）。
+ * 登録済の種類については、録音中も購読者を追加・削除できる。購読者一覧は新しい一覧を作ってポインタを差し替えることで更新され、モニタリングコールバックのスレッドはアトミック変数の読み書きのみを行う。
+ * 古い一覧は、それを参照しているモニタリングコールバックが終わるのを subscribe(), unsubscribe() の側で待ってから解放するので、モニタリングコールバックのスレッドがロックを待ったり、メモリを解放したりすることはない。
+ * 購読者に与えられるバッファは全購読者で共有されるので、書き換えてはならない。
+ * 購読者のコールバック関数の中から subscribe(), unsubscribe() を呼び出してはならない（自身の終了を待つことになる）。
+ * libmimixfe はこのオブジェクト内のアドレスを userdata として保持し、デストラクタは delMonitoringCallback() を呼び出すので、このオブジェクトは XFERecorder::stop() の後、実行中のモニタリングコールバックがなくなるまで破棄してはならない。
+ */
+class MonitoringHub
+{
+public:
+	explicit MonitoringHub(mimixfe::XFERecorder& recorder) : recorder_(recorder), nextId_(0)
+	{
+		for(int i=0;i<numTypes_;++i){
+			taps_[i].type_ = static_cast<mimixfe::MonitoringAudioType>(i);
+			taps_[i].libraryId_ = -1;
+			taps_[i].subscribers_.store(new std::vector<Subscriber>());
+			taps_[i].readers_.store(0);
+		}
+	}
+
+	~MonitoringHub()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		for(int i=0;i<numTypes_;++i){
+			if(taps_[i].libraryId_ >= 0){
+				recorder_.delMonitoringCallback(taps_[i].libraryId_);
+			}
+			retire(taps_[i], nullptr);
+		}
+	}
+
+	/**
+	 * @brief 購読者を追加する
+	 * @param [in] type モニタリングタイプ
+	 * @param [in] callback モニタリングコールバック関数
+	 * @param [in] userdata 任意データ
+	 * @return 成功した場合、購読番号（0 以上の整数）が返る。libmimixfe へのモニタリングコールバックの登録に失敗した場合、及び未登録の種類を録音中に追加しようとした場合、負の数となる。
+	 */
+	int subscribe(mimixfe::MonitoringAudioType type, mimixfe::monitoringCallback_t callback, void* userdata)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		Tap& tap = taps_[static_cast<int>(type)];
+		if(tap.libraryId_ < 0){
+			if(recorder_.isActive()){
+				return -1; // 録音中に libmimixfe へ登録することはしない
+			}
+			tap.libraryId_ = recorder_.addMonitoringCallback(dispatch, type, mimixfe::AudioCodec::RAWPCM, &tap);
+			if(tap.libraryId_ < 0){
+				return tap.libraryId_;
+			}
+		}
+		std::vector<Subscriber>* next = new std::vector<Subscriber>(*tap.subscribers_.load());
+		const int id = nextId_++;
+		next->push_back(Subscriber{id, callback, userdata});
+		retire(tap, next);
+		return id;
+	}
+
+	/**
+	 * @brief 購読者を削除する。この関数から戻った後は、削除した購読者が呼ばれることはない。
+	 * @details 最後の購読者を削除しても libmimixfe への登録は削除しないので、録音中に呼び出してよい。
+	 * @param [in] id subscribe() の戻り値
+	 * @return 成功した場合、削除された購読番号（引数の値）が返る。該当する購読者がいない場合、負の数となる。
+	 */
+	int unsubscribe(int id)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		for(int i=0;i<numTypes_;++i){
+			Tap& tap = taps_[i];
+			const std::vector<Subscriber>* current = tap.subscribers_.load();
+			auto it = std::find_if(current->begin(), current->end(), [id](const Subscriber& s){ return s.id_ == id; });
+			if(it == current->end()){
+				continue;
+			}
+			std::vector<Subscriber>* next = new std::vector<Subscriber>(*current);
+			next->erase(next->begin() + (it - current->begin()));
+			retire(tap, next);
+			return id;
+		}
+		return -1;
+	}
+
+private:
+	static const int numTypes_ = 5; //!< MonitoringAudioType の種類数
+
+	class Subscriber
+	{
+	public:
+		int id_;
+		mimixfe::monitoringCallback_t callback_;
+		void* userdata_;
+	};
+
+	class Tap
+	{
+	public:
+		mimixfe::MonitoringAudioType type_;
+		int libraryId_; //!< addMonitoringCallback() の戻り値。未登録の場合 -1
+		std::atomic<const std::vector<Subscriber>*> subscribers_;
+		std::atomic<int> readers_; //!< 購読者一覧を参照中のモニタリングコールバックの数
+	};
+
+	MonitoringHub(const MonitoringHub&) = delete;
+	MonitoringHub& operator=(const MonitoringHub&) = delete;
+
+	/**
+	 * @brief 購読者一覧を next に差し替え、古い一覧を参照しているモニタリングコールバックが終わるのを待ってから解放する
+	 */
+	static void retire(Tap& tap, const std::vector<Subscriber>* next)
+	{
+		const std::vector<Subscriber>* previous = tap.subscribers_.exchange(next);
+		while(tap.readers_.load() != 0){
+			std::this_thread::yield();
+		}
+		delete previous;
+	}
+
+	static void dispatch(const short* buffer, size_t buflen, void* userdata)
+	{
+		Tap* tap = reinterpret_cast<Tap*>(userdata);
+		tap->readers_.fetch_add(1);
+		const std::vector<Subscriber>* subscribers = tap->subscribers_.load();
+		if(subscribers != nullptr){
+			for(const Subscriber& s : *subscribers){
+				s.callback_(buffer, buflen, s.userdata_);
+			}
+		}
+		tap->readers_.fetch_sub(1);
+	}
+
+	mimixfe::XFERecorder& recorder_;
+	std::mutex mutex_; //!< subscribe(), unsubscribe() の排他のみに用いる
+	Tap taps_[numTypes_];
+	int nextId_;
+};
+
+#endif /* MIMIXFE_EXAMPLES_MONITORING_HUB_H_ */
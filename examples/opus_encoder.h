@@ -0,0 +1,163 @@
+/*
+ * @file opus_encoder.h
+ * \~english
+ * @brief Streaming Opus encoder running on a worker thread
+ * \~japanese
+ * @brief ワーカースレッドで動作するストリーミング Opus エンコーダ
+ * \~
+ * @copyright Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ * @copyright Apache License, Version 2.0
+ *
+ * Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MIMIXFE_EXAMPLES_OPUS_ENCODER_H_
+#define MIMIXFE_EXAMPLES_OPUS_ENCODER_H_
+
+#include <vector>
+#include <stdexcept>
+#include <opus/opus.h>
+
+#include "stream_encoder.h"
+
+/**
+ * @class OpusStreamEncoder
+ * @brief 16bit PCM を、ワーカースレッドで逐次 Opus に圧縮する
+ * @details encodedCallback_t には、1 回の呼び出しにつき 1 つの Opus パケット（コンテナなし）が与えられる。ストリームの末尾でフレーム長に満たないサンプルは無音で補われる。
+ * Ogg 等のコンテナへの格納が必要な場合は、encodedCallback_t 内で行う。
+ */
+class OpusStreamEncoder : public StreamEncoder
+{
+public:
+	/**
+	 * @brief コンストラクタ
+	 * @param [in] callback 圧縮済音声を受け取るコールバック関数。ワーカースレッドから呼ばれる。
+	 * @param [in] userdata 任意データ
+	 * @param [in] bitrate ビットレート[bps] [500,512000]
+	 * @param [in] frameMs フレーム長[ms]。10 もしくは 20。
+	 * @param [in] complexity エンコーダの計算量 [0,10]。大きいほど高音質だが処理が重い。
+	 * @param [in] samplingrate サンプリングレート（8000, 12000, 16000, 24000, 48000 のいずれか）
+	 * @param [in] channels チャネル数 [1,2]
+	 */
+	OpusStreamEncoder(encodedCallback_t callback, void* userdata,
+			int bitrate = 24000, int frameMs = 20, int complexity = 5, int samplingrate = 16000, unsigned channels = 1) :
+		StreamEncoder(callback, userdata, channels),
+		bitrate_(bitrate), complexity_(complexity), samplingrate_(samplingrate),
+		frameSamples_(samplingrate / 1000 * frameMs * channels), packet_(4000), encoder_(nullptr)
+	{
+		if(samplingrate != 8000 && samplingrate != 12000 && samplingrate != 16000 && samplingrate != 24000 && samplingrate != 48000){
+			throw std::invalid_argument("OpusStreamEncoder: sampling rate must be 8000, 12000, 16000, 24000 or 48000 Hz");
+		}
+		if(bitrate < 500 || bitrate > 512000){
+			throw std::invalid_argument("OpusStreamEncoder: bitrate must be between 500 and 512000 bps");
+		}
+		if(complexity < 0 || complexity > 10){
+			throw std::invalid_argument("OpusStreamEncoder: complexity must be between 0 and 10");
+		}
+		if(frameMs != 10 && frameMs != 20){
+			throw std::invalid_argument("OpusStreamEncoder: frame duration must be 10 or 20 ms");
+		}
+		if(channels_ == 0 || channels_ > 2){
+			throw std::invalid_argument("OpusStreamEncoder: unsupported number of channels");
+		}
+		pending_.reserve(frameSamples_);
+		startWorker();
+	}
+
+	~OpusStreamEncoder(){ stopWorker(); }
+
+private:
+	bool openStream() override
+	{
+		int error = OPUS_OK;
+		encoder_ = opus_encoder_create(samplingrate_, channels_, OPUS_APPLICATION_VOIP, &error);
+		if(error != OPUS_OK || encoder_ == nullptr){
+			encoder_ = nullptr;
+			return false;
+		}
+		if(opus_encoder_ctl(encoder_, OPUS_SET_BITRATE(bitrate_)) != OPUS_OK ||
+		   opus_encoder_ctl(encoder_, OPUS_SET_COMPLEXITY(complexity_)) != OPUS_OK ||
+		   opus_encoder_ctl(encoder_, OPUS_SET_SIGNAL(OPUS_SIGNAL_VOICE)) != OPUS_OK){
+			opus_encoder_destroy(encoder_);
+			encoder_ = nullptr;
+			return false;
+		}
+		pending_.clear();
+		return true;
+	}
+
+	bool closeStream() override
+	{
+		bool ok = true;
+		if(!pending_.empty()){
+			pending_.resize(frameSamples_, 0);
+			ok = encodeFrame(pending_.data());
+			pending_.clear();
+		}
+		opus_encoder_destroy(encoder_);
+		encoder_ = nullptr;
+		return ok;
+	}
+
+	bool encode(const short* buffer, size_t len) override
+	{
+		size_t offset = 0;
+		// 前回の残りがある場合は、1 フレーム分揃えてから圧縮する
+		if(!pending_.empty()){
+			const size_t n = std::min(len, frameSamples_ - pending_.size());
+			pending_.insert(pending_.end(), buffer, buffer + n);
+			offset += n;
+			if(pending_.size() < frameSamples_){
+				return true;
+			}
+			const bool ok = encodeFrame(pending_.data());
+			pending_.clear();
+			if(!ok){
+				return false;
+			}
+		}
+		for(;offset + frameSamples_ <= len;offset += frameSamples_){
+			if(!encodeFrame(buffer + offset)){
+				return false;
+			}
+		}
+		pending_.insert(pending_.end(), buffer + offset, buffer + len);
+		return true;
+	}
+
+	/**
+	 * @brief 1 フレームを圧縮して出力する。opus_encode() が失敗した場合 false
+	 */
+	bool encodeFrame(const short* frame)
+	{
+		const opus_int32 bytes = opus_encode(encoder_, frame, frameSamples_ / channels_, packet_.data(), packet_.size());
+		if(bytes < 0){
+			return false;
+		}
+		if(bytes > 0){
+			emit(packet_.data(), bytes);
+		}
+		return true;
+	}
+
+	const int bitrate_;
+	const int complexity_;
+	const int samplingrate_;
+	const size_t frameSamples_;           //!< 1 フレームのサンプル数（全チャネル分）
+	std::vector<short> pending_;          //!< 1 フレームに満たない未圧縮サンプル
+	std::vector<unsigned char> packet_;   //!< 圧縮済パケットの作業領域
+	OpusEncoder* encoder_;
+};
+
+#endif /* MIMIXFE_EXAMPLES_OPUS_ENCODER_H_ */
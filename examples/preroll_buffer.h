@@ -0,0 +1,222 @@
+/*
+ * @file preroll_buffer.h
+ * \~english
+ * @brief Fixed-size preallocated ring buffer that returns the last N seconds of audio on request
+ * \~japanese
+ * @brief 直近 N 秒分の音声を要求に応じて取り出せる、事前確保された固定長のリングバッファ
+ * \~
+ * @copyright Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ * @copyright Apache License, Version 2.0
+ *
+ * Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MIMIXFE_EXAMPLES_PREROLL_BUFFER_H_
+#define MIMIXFE_EXAMPLES_PREROLL_BUFFER_H_
+
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <stdint.h>
+#include <string.h>
+#include <stddef.h>
+
+#include "XFETypedef.h"
+
+/**
+ * @class PrerollBuffer
+ * @brief 書き込まれた音声のうち直近 maxSeconds 秒分を保持し、任意のスレッドから直近 N 秒分を取り出せるリングバッファ
+ * @details 書き込みは 1 つのスレッド（モニタリングコールバックもしくは録音コールバック）からのみ行う。領域はコンストラクタで確保され、書き込み時にメモリ確保やロックは起きない。
+ * 読み出し側は書き込みを待たせない。読み出し中に対象の区間が上書きされた場合、もしくは overwrite() で書き換えられた場合は読み出しをやり直す。上書きまでの猶予として、maxSeconds 秒に加えて 1 秒分の領域を確保する。
+ * 多チャネル音声はインターリーブされたまま保持され、フレーム（全チャネル分のサンプル）単位で扱われる。
+ */
+class PrerollBuffer
+{
+public:
+	/**
+	 * @brief コンストラクタ
+	 * @param [in] channels チャネル数（S16kC16EC の場合 16、録音コールバックの場合 1）
+	 * @param [in] maxSeconds 取り出せる最大の長さ[s]
+	 * @param [in] samplingrate サンプリングレート
+	 */
+	PrerollBuffer(size_t channels, int maxSeconds, int samplingrate = 16000) :
+		channels_(channels), samplingrate_(samplingrate),
+		maxFrames_(static_cast<uint64_t>(maxSeconds) * samplingrate),
+		capacityFrames_(static_cast<uint64_t>(maxSeconds + slackSeconds_) * samplingrate),
+		writing_(0), written_(0), rewrites_(0)
+	{
+		if(channels == 0 || maxSeconds <= 0 || samplingrate <= 0){
+			throw std::invalid_argument("PrerollBuffer: channels, length and sampling rate must be positive");
+		}
+		buffer_.resize(capacityFrames_ * channels_);
+	}
+
+	/**
+	 * @brief XFERecorder::addMonitoringCallback() に与える monitoringCallback_t。userdata には PrerollBuffer へのポインタを与える。
+	 */
+	static void monitoringCallback(const short* buffer, size_t buflen, void* userdata)
+	{
+		reinterpret_cast<PrerollBuffer*>(userdata)->write(buffer, buflen);
+	}
+
+	/**
+	 * @brief 音声を書き込む。書き込みは常に同じ 1 つのスレッドから行うこと。
+	 * @param [in] buffer インターリーブされた音声
+	 * @param [in] buflen サンプル数（フレーム数 × チャネル数）
+	 */
+	void write(const short* buffer, size_t buflen)
+	{
+		writeFrames(buffer, buflen / channels_);
+	}
+
+	/**
+	 * @brief 無音を書き込む。音声が出力されない区間を埋めて、書き込まれた音声の時間を実際の時間に揃えるために用いる。
+	 * @param [in] frames フレーム数
+	 */
+	void writeSilence(uint64_t frames)
+	{
+		writeFrames(nullptr, frames);
+	}
+
+	/**
+	 * @brief 書き込み済の区間を書き換える。writeSilence() で埋めた区間に、後から届いた音声を書き込むために用いる。
+	 * @details write() と同じスレッドから呼び出すこと。書き換え中に読み出された場合、読み出し側はやり直す。
+	 * 書き込み済の範囲を超える部分と、既に保持されていない古い部分は書き込まれない。
+	 * @param [in] position 書き換えを始める位置（これまでに書き込まれた総フレーム数で数える）
+	 * @param [in] buffer インターリーブされた音声
+	 * @param [in] buflen サンプル数（フレーム数 × チャネル数）
+	 */
+	void overwrite(uint64_t position, const short* buffer, size_t buflen)
+	{
+		const uint64_t end = written_.load(std::memory_order_relaxed);
+		const uint64_t oldest = end > capacityFrames_ ? end - capacityFrames_ : 0;
+		uint64_t frames = buflen / channels_;
+		if(position < oldest){
+			const uint64_t skip = std::min(frames, oldest - position);
+			buffer += skip * channels_;
+			frames -= skip;
+			position += skip;
+		}
+		if(position >= end || frames == 0){
+			return;
+		}
+		frames = std::min(frames, end - position);
+		// 書き換え中であることを先に公開し、読み出し側が書き換えを検出できるようにする
+		const uint64_t rewrites = rewrites_.load(std::memory_order_relaxed);
+		rewrites_.store(rewrites + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		copyIn(position, buffer, frames);
+		rewrites_.store(rewrites + 2, std::memory_order_release);
+	}
+
+	/**
+	 * @brief 直近の音声を取り出す。任意のスレッドから呼び出せる。
+	 * @param [out] out 取り出した音声（インターリーブ）。必要に応じて大きさが変更される。
+	 * @param [in] seconds 取り出す長さ[s]。maxSeconds を超える場合は maxSeconds 秒となる。
+	 * @return 取り出したフレーム数。書き込まれた音声が seconds 秒に満たない場合は、書き込まれた全ての音声となる。
+	 */
+	size_t read(std::vector<short>& out, double seconds) const
+	{
+		const uint64_t request = std::min(maxFrames_, static_cast<uint64_t>(std::max(seconds, 0.0) * samplingrate_));
+		for(;;){
+			const uint64_t rewrites = rewrites_.load(std::memory_order_acquire);
+			if(rewrites % 2 != 0){
+				continue; // 書き換え中
+			}
+			const uint64_t end = written_.load(std::memory_order_acquire);
+			const uint64_t frames = std::min(request, end);
+			const uint64_t begin = end - frames;
+			out.resize(frames * channels_);
+			if(frames == 0){
+				return 0;
+			}
+			copyOut(begin, out.data(), frames);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if(writing_.load(std::memory_order_relaxed) <= begin + capacityFrames_ &&
+					rewrites_.load(std::memory_order_relaxed) == rewrites){
+				return frames;
+			}
+		}
+	}
+
+	/**
+	 * @brief これまでに書き込まれた総フレーム数
+	 */
+	uint64_t written() const { return written_.load(std::memory_order_acquire); }
+
+	size_t channels() const { return channels_; }
+
+private:
+	static const int slackSeconds_ = 1; //!< 読み出し中に上書きされないための余裕[s]
+
+	PrerollBuffer(const PrerollBuffer&) = delete;
+	PrerollBuffer& operator=(const PrerollBuffer&) = delete;
+
+	/**
+	 * @brief frames フレームを書き込む。src が nullptr の場合は無音を書き込む。
+	 */
+	void writeFrames(const short* src, uint64_t frames)
+	{
+		if(frames == 0){
+			return;
+		}
+		uint64_t begin = written_.load(std::memory_order_relaxed);
+		if(frames > capacityFrames_){
+			// 保持できない古い部分は書き込まずに読み飛ばす
+			if(src != nullptr){
+				src += (frames - capacityFrames_) * channels_;
+			}
+			begin += frames - capacityFrames_;
+			frames = capacityFrames_;
+		}
+		// 上書きする範囲を先に公開し、読み出し側が上書きを検出できるようにする
+		writing_.store(begin + frames, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		copyIn(begin, src, frames);
+		written_.store(begin + frames, std::memory_order_release);
+	}
+
+	void copyIn(uint64_t position, const short* src, uint64_t frames)
+	{
+		const uint64_t offset = position % capacityFrames_;
+		const uint64_t first = std::min(frames, capacityFrames_ - offset);
+		if(src == nullptr){
+			memset(&buffer_[offset * channels_], 0, first * channels_ * sizeof(short));
+			memset(&buffer_[0], 0, (frames - first) * channels_ * sizeof(short));
+			return;
+		}
+		memcpy(&buffer_[offset * channels_], src, first * channels_ * sizeof(short));
+		memcpy(&buffer_[0], src + first * channels_, (frames - first) * channels_ * sizeof(short));
+	}
+
+	void copyOut(uint64_t position, short* dst, uint64_t frames) const
+	{
+		const uint64_t offset = position % capacityFrames_;
+		const uint64_t first = std::min(frames, capacityFrames_ - offset);
+		memcpy(dst, &buffer_[offset * channels_], first * channels_ * sizeof(short));
+		memcpy(dst + first * channels_, &buffer_[0], (frames - first) * channels_ * sizeof(short));
+	}
+
+	const size_t channels_;
+	const int samplingrate_;
+	const uint64_t maxFrames_;      //!< 取り出せる最大フレーム数
+	const uint64_t capacityFrames_; //!< リングバッファのフレーム数
+	std::vector<short> buffer_;
+	std::atomic<uint64_t> writing_; //!< 書き込み中の区間の終端（総フレーム数）
+	std::atomic<uint64_t> written_; //!< 書き込みが完了した総フレーム数
+	std::atomic<uint64_t> rewrites_; //!< overwrite() の開始時と終了時に 1 ずつ増える。奇数の間は書き換え中
+};
+
+#endif /* MIMIXFE_EXAMPLES_PREROLL_BUFFER_H_ */
@@ -0,0 +1,189 @@
+/*
+ * @file resampler.h
+ * \~english
+ * @brief Streaming polyphase resampler for recorder callback output (e.g. 16 kHz to 8 kHz or 48 kHz)
+ * \~japanese
+ * @brief コールバック関数に与えられる音声を逐次変換するポリフェーズ型サンプリングレート変換器（16kHz から 8kHz, 48kHz 等）
+ * \~
+ * @copyright Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ * @copyright Apache License, Version 2.0
+ *
+ * Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MIMIXFE_EXAMPLES_RESAMPLER_H_
+#define MIMIXFE_EXAMPLES_RESAMPLER_H_
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @class PolyphaseResampler
+ * @brief 1ch 音声のサンプリングレートを有理数比 L/M で変換する。Kaiser 窓付き sinc 関数の低域通過フィルタをポリフェーズ分解して用いる。
+ * @details 呼び出しをまたいでフィルタの状態を保持するので、コールバック関数ごとに process() を呼び出せば連続した音声として変換される。
+ * 出力はフィルタの群遅延を補償した位置から始まり、flush() の後の総出力サンプル数は総入力サンプル数 × L / M（切り上げ）に一致する。
+ * 作業領域は再利用されるので、定常状態ではメモリ確保は起きない。発話ごとに独立した音声として変換する場合は、発話の終わりで flush() を呼び出す。
+ */
+class PolyphaseResampler
+{
+public:
+	/**
+	 * @brief コンストラクタ
+	 * @param [in] inputRate 入力サンプリングレート
+	 * @param [in] outputRate 出力サンプリングレート
+	 * @param [in] zeroCrossings フィルタの片側の零交差数。大きいほど遷移帯域が狭く通過帯域が広くなるが、遅延と計算量が増える。
+	 * 既定値 32 では、通過帯域は低い方のナイキスト周波数の約 84% まで、阻止域はナイキスト周波数以上となる。
+	 */
+	PolyphaseResampler(int inputRate, int outputRate, int zeroCrossings = 32) :
+		up_(0), down_(0), tapsPerPhase_(0), delay_(0)
+	{
+		if(inputRate <= 0 || outputRate <= 0 || zeroCrossings <= 0){
+			throw std::invalid_argument("PolyphaseResampler: rates and zero crossings must be positive");
+		}
+		const int g = gcd(inputRate, outputRate);
+		up_ = outputRate / g;
+		down_ = inputRate / g;
+
+		// 阻止域の始まりが低い方のナイキスト周波数に一致するよう、遷移帯域幅の半分だけ遮断周波数（-6dB 点）を下げる
+		const int factor = std::max(up_, down_);
+		const int length = 2 * zeroCrossings * factor + 1;
+		const double center = (length - 1) / 2.0;
+		const double attenuation = kaiserBeta_ / 0.1102 + 8.7; // Kaiser 窓の阻止域減衰量[dB]
+		const double transition = (attenuation - 7.95) / (2.285 * 2.0 * M_PI * (length - 1)); // 遷移帯域幅
+		const double cutoff = 0.5 / factor - transition / 2.0; // 入力を up_ 倍に補間した信号に対する正規化周波数
+		tapsPerPhase_ = (length + up_ - 1) / up_;
+		phases_.assign(static_cast<size_t>(up_) * tapsPerPhase_, 0.0F);
+		for(int k=0;k<length;++k){
+			const double x = k - center;
+			const double sinc = x == 0 ? 2.0 * cutoff : std::sin(2.0 * M_PI * cutoff * x) / (M_PI * x);
+			const double r = x / center;
+			const double window = besselI0(kaiserBeta_ * std::sqrt(std::max(0.0, 1.0 - r * r))) / besselI0(kaiserBeta_);
+			// フェーズ p の j 番目の係数は h[p + j * up_]
+			phases_[static_cast<size_t>(k % up_) * tapsPerPhase_ + k / up_] = static_cast<float>(up_ * sinc * window);
+		}
+		delay_ = static_cast<uint64_t>(center / down_ + 0.5);
+		reset();
+	}
+
+	/**
+	 * @brief 音声を変換し、out の末尾に追加する
+	 * @param [in] buffer 入力音声
+	 * @param [in] buflen 入力サンプル数
+	 * @param [out] out 出力音声
+	 */
+	void process(const short* buffer, size_t buflen, std::vector<short>& out)
+	{
+		inputs_ += buflen;
+		for(size_t i=0;i<buflen;++i){
+			history_.push_back(buffer[i]);
+		}
+		filter(out);
+	}
+
+	/**
+	 * @brief フィルタに残っている音声を出力し、状態を初期化する
+	 * @param [out] out 出力音声
+	 */
+	void flush(std::vector<short>& out)
+	{
+		const uint64_t total = (inputs_ * up_ + down_ - 1) / down_;
+		while(outputs_ < total){
+			history_.insert(history_.end(), tapsPerPhase_, 0.0F);
+			filter(out, total);
+		}
+		reset();
+	}
+
+	/**
+	 * @brief 状態を初期化する
+	 */
+	void reset()
+	{
+		history_.assign(tapsPerPhase_ - 1, 0.0F);
+		position_ = tapsPerPhase_ - 1;
+		phase_ = 0;
+		inputs_ = 0;
+		outputs_ = 0;
+		skip_ = delay_;
+	}
+
+	/**
+	 * @brief 入力に対する出力の遅延[出力サンプル]
+	 */
+	uint64_t delay() const { return delay_; }
+
+private:
+	static constexpr double kaiserBeta_ = 8.0; //!< 阻止域減衰量約 80dB（阻止域はナイキスト周波数以上）
+
+	static int gcd(int a, int b){ return b == 0 ? a : gcd(b, a % b); }
+
+	static double besselI0(double x)
+	{
+		double sum = 1.0;
+		double term = 1.0;
+		for(int k=1;k<50;++k){
+			term *= (x / (2.0 * k)) * (x / (2.0 * k));
+			sum += term;
+			if(term < sum * 1e-12){
+				break;
+			}
+		}
+		return sum;
+	}
+
+	void filter(std::vector<short>& out, uint64_t limit = UINT64_MAX)
+	{
+		while(position_ < history_.size() && outputs_ < limit){
+			const float* h = &phases_[static_cast<size_t>(phase_) * tapsPerPhase_];
+			const float* x = &history_[position_];
+			float y = 0;
+			for(int j=0;j<tapsPerPhase_;++j){
+				y += h[j] * x[-j];
+			}
+			phase_ += down_;
+			position_ += phase_ / up_;
+			phase_ %= up_;
+			if(skip_ > 0){
+				// 群遅延分の出力を捨てて、入力と時刻を揃える
+				skip_--;
+				continue;
+			}
+			y = std::min(32767.0F, std::max(-32768.0F, std::round(y)));
+			out.push_back(static_cast<short>(y));
+			outputs_++;
+		}
+		// 次の出力に必要な分だけ残す
+		const size_t keep = std::min(position_, history_.size()) - (tapsPerPhase_ - 1);
+		history_.erase(history_.begin(), history_.begin() + keep);
+		position_ -= keep;
+	}
+
+	int up_;                     //!< 補間率 L
+	int down_;                   //!< 間引き率 M
+	int tapsPerPhase_;           //!< フェーズあたりのタップ数
+	uint64_t delay_;             //!< 群遅延[出力サンプル]
+	std::vector<float> phases_;  //!< ポリフェーズ分解したフィルタ係数（フェーズごとに tapsPerPhase_ 個）
+	std::vector<float> history_; //!< 入力音声（先頭 tapsPerPhase_ - 1 サンプルは前回までの入力）
+	size_t position_;            //!< 次の出力に用いる最新の入力の位置
+	int phase_;                  //!< 次の出力のフェーズ
+	uint64_t inputs_;            //!< 総入力サンプル数
+	uint64_t outputs_;           //!< 総出力サンプル数
+	uint64_t skip_;              //!< 捨てる残りの出力サンプル数
+};
+
+#endif /* MIMIXFE_EXAMPLES_RESAMPLER_H_ */
@@ -0,0 +1,226 @@
+/*
+ * @file source_batcher.h
+ * \~english
+ * @brief Batches per-source recorder callbacks of one time slice into a single struct-of-arrays callback
+ * \~japanese
+ * @brief 同じ時間区間の音源ごとのコールバックを 1 回の構造体配列形式のコールバックにまとめる
+ * \~
+ * @copyright Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ * @copyright Apache License, Version 2.0
+ *
+ * Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MIMIXFE_EXAMPLES_SOURCE_BATCHER_H_
+#define MIMIXFE_EXAMPLES_SOURCE_BATCHER_H_
+
+#include <vector>
+#include <algorithm>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+#include "XFETypedef.h"
+
+/**
+ * @class SourceBatch
+ * @brief 同じ時間区間の全音源の音声と解析結果。解析結果は項目ごとに全音源分が連続した配列として格納される。
+ * @details 音源 i の音声は audio_[i] から audioLen_[i] サンプル、解析結果は各配列の frameOffset_[i] から numFrames_[i] 個である。
+ * audio_[i] は alignment_ バイト境界に揃えられている。ポインタは batchCallback_t の呼び出し中のみ有効である。
+ */
+class SourceBatch
+{
+public:
+	static const size_t maxSources_ = 8;  //!< 1 つの時間区間に含まれる最大音源数
+	static const size_t alignment_ = 32;  //!< 音声バッファの境界[byte]
+
+	size_t numSources_;                           //!< 音源数
+	int sourceId_[maxSources_];                   //!< 音源番号
+	mimixfe::SpeechState state_[maxSources_];     //!< 発話検出状態
+	const short* audio_[maxSources_];             //!< 音声
+	size_t audioLen_[maxSources_];                //!< 音声のサンプル数
+	size_t frameOffset_[maxSources_];             //!< 解析結果の配列における先頭位置
+	size_t numFrames_[maxSources_];               //!< 解析結果の個数
+
+	size_t totalFrames_;                          //!< 全音源の解析結果の個数
+	const unsigned long long* milliseconds_;      //!< 経過時間[ms]
+	const int* azimuth_;                          //!< 10msec フレームの推定方向の方位角
+	const int* angle_;                            //!< 10msec フレームの推定方向の迎え角
+	const float* speechProbability_;              //!< 10msec フレームの発話存在確率[0,1]
+	const float* rmsDbfs_;                        //!< 平均音量[dbfs]
+};
+
+/**
+ * @brief SourceBatcher がまとめた結果を受け取るコールバック関数
+ */
+using batchCallback_t = void (*)(
+		const SourceBatch& batch,
+		void* userdata);
+
+/**
+ * @class SourceBatcher
+ * @brief recorderCallback_t として XFERecorder に与え、音源ごとの呼び出しを時間区間ごとにまとめて batchCallback_t を呼び出す
+ * @details libmimixfe は同じ時間区間について音源ごとに 1 回ずつコールバック関数を呼び出す。時間区間は各呼び出しの最後の StreamInfo の経過時間で識別し、
+ * その時点の抽出音源数（StreamInfo::numSoundSources_）の呼び出しが揃った時点、もしくはまとめている全ての音源が SpeechEnd となった時点で出力する。
+ * 揃う前に別の時間区間の呼び出しが来た場合は、その時点でそれまでの分を出力する。XFERecorder::stop() の後に flush() を呼び出して残りを出力すること。
+ * 作業領域は再利用されるので、定常状態ではメモリ確保は起きない。
+ */
+class SourceBatcher
+{
+public:
+	SourceBatcher(batchCallback_t callback, void* userdata) :
+		callback_(callback), userdata_(userdata), audio_(nullptr), audioCapacity_(0), audioUsed_(0), sliceMs_(0), expectedSources_(0)
+	{
+		batch_.numSources_ = 0;
+		reserveAudio(SourceBatch::maxSources_ * 1600);
+		milliseconds_.reserve(SourceBatch::maxSources_ * 100);
+		azimuth_.reserve(SourceBatch::maxSources_ * 100);
+		angle_.reserve(SourceBatch::maxSources_ * 100);
+		speechProbability_.reserve(SourceBatch::maxSources_ * 100);
+		rmsDbfs_.reserve(SourceBatch::maxSources_ * 100);
+	}
+
+	~SourceBatcher(){ free(audio_); }
+
+	/**
+	 * @brief XFERecorder に与える recorderCallback_t。userdata には SourceBatcher へのポインタを与える。
+	 */
+	static void recorderCallback(
+			short* buffer,
+			size_t buflen,
+			mimixfe::SpeechState state,
+			int sourceId,
+			mimixfe::StreamInfo* info,
+			size_t infolen,
+			void* userdata)
+	{
+		reinterpret_cast<SourceBatcher*>(userdata)->add(buffer, buflen, state, sourceId, info, infolen);
+	}
+
+	/**
+	 * @brief 1 音源分の呼び出しを追加する
+	 */
+	void add(const short* buffer, size_t buflen, mimixfe::SpeechState state, int sourceId, const mimixfe::StreamInfo* info, size_t infolen)
+	{
+		// StreamInfo がない呼び出しは、まとめている時間区間に含める
+		const bool hasSlice = infolen != 0;
+		const unsigned long long sliceMs = hasSlice ? info[infolen-1].milliseconds_ : sliceMs_;
+		const size_t n = batch_.numSources_;
+		if(n != 0 && (sliceMs != sliceMs_ || std::find(batch_.sourceId_, batch_.sourceId_ + n, sourceId) != batch_.sourceId_ + n)){
+			flush();
+		}
+		sliceMs_ = sliceMs;
+		if(hasSlice){
+			expectedSources_ = std::max(expectedSources_, static_cast<size_t>(std::max(info[infolen-1].numSoundSources_, 0)));
+		}
+		const size_t i = batch_.numSources_++;
+		batch_.sourceId_[i] = sourceId;
+		batch_.state_[i] = state;
+
+		// 音源ごとの先頭を境界に揃える
+		const size_t align = SourceBatch::alignment_ / sizeof(short);
+		const size_t offset = (audioUsed_ + align - 1) / align * align;
+		reserveAudio(offset + buflen);
+		memcpy(audio_ + offset, buffer, buflen * sizeof(short));
+		audioOffset_[i] = offset;
+		batch_.audioLen_[i] = buflen;
+		audioUsed_ = offset + buflen;
+
+		batch_.frameOffset_[i] = milliseconds_.size();
+		batch_.numFrames_[i] = infolen;
+		for(size_t k=0;k<infolen;++k){
+			milliseconds_.push_back(info[k].milliseconds_);
+			azimuth_.push_back(info[k].direction_.azimuth_);
+			angle_.push_back(info[k].direction_.angle_);
+			speechProbability_.push_back(info[k].speechProbability_);
+			rmsDbfs_.push_back(info[k].rmsDbfs_);
+		}
+
+		// 抽出音源数が揃った、もしくは全ての音源の発話が終わった場合は、次の呼び出しを待たずに出力する
+		const size_t m = batch_.numSources_;
+		const bool allEnded = std::all_of(batch_.state_, batch_.state_ + m, [](mimixfe::SpeechState s){ return s == mimixfe::SpeechState::SpeechEnd; });
+		if(m == SourceBatch::maxSources_ || m >= expectedSources_ || allEnded){
+			flush();
+		}
+	}
+
+	/**
+	 * @brief まとめている分を出力する
+	 */
+	void flush()
+	{
+		if(batch_.numSources_ == 0){
+			return;
+		}
+		for(size_t i=0;i<batch_.numSources_;++i){
+			batch_.audio_[i] = audio_ + audioOffset_[i];
+		}
+		batch_.totalFrames_ = milliseconds_.size();
+		batch_.milliseconds_ = milliseconds_.data();
+		batch_.azimuth_ = azimuth_.data();
+		batch_.angle_ = angle_.data();
+		batch_.speechProbability_ = speechProbability_.data();
+		batch_.rmsDbfs_ = rmsDbfs_.data();
+		callback_(batch_, userdata_);
+
+		batch_.numSources_ = 0;
+		expectedSources_ = 0;
+		audioUsed_ = 0;
+		milliseconds_.clear();
+		azimuth_.clear();
+		angle_.clear();
+		speechProbability_.clear();
+		rmsDbfs_.clear();
+	}
+
+private:
+	SourceBatcher(const SourceBatcher&) = delete;
+	SourceBatcher& operator=(const SourceBatcher&) = delete;
+
+	void reserveAudio(size_t samples)
+	{
+		if(samples <= audioCapacity_){
+			return;
+		}
+		const size_t capacity = std::max(samples, audioCapacity_ * 2);
+		void* p = nullptr;
+		if(posix_memalign(&p, SourceBatch::alignment_, capacity * sizeof(short)) != 0){
+			throw std::bad_alloc();
+		}
+		if(audio_ != nullptr){
+			memcpy(p, audio_, audioUsed_ * sizeof(short));
+			free(audio_);
+		}
+		audio_ = reinterpret_cast<short*>(p);
+		audioCapacity_ = capacity;
+	}
+
+	const batchCallback_t callback_;
+	void* const userdata_;
+	SourceBatch batch_;
+	short* audio_;                            //!< 全音源分の音声（alignment_ バイト境界）
+	size_t audioCapacity_;
+	size_t audioUsed_;
+	size_t audioOffset_[SourceBatch::maxSources_];
+	unsigned long long sliceMs_;              //!< まとめている時間区間の最後のフレームの経過時間[ms]
+	size_t expectedSources_;                  //!< まとめている時間区間の抽出音源数
+	std::vector<unsigned long long> milliseconds_;
+	std::vector<int> azimuth_;
+	std::vector<int> angle_;
+	std::vector<float> speechProbability_;
+	std::vector<float> rmsDbfs_;
+};
+
+#endif /* MIMIXFE_EXAMPLES_SOURCE_BATCHER_H_ */
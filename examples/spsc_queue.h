@@ -0,0 +1,213 @@
+/*
+ * @file spsc_queue.h
+ * \~english
+ * @brief Bounded lock-free single-producer/single-consumer queue
+ * \~japanese
+ * @brief 固定長ロックフリー単一生産者・単一消費者キュー
+ * \~
+ * @copyright Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ * @copyright Apache License, Version 2.0
+ *
+ * Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MIMIXFE_EXAMPLES_SPSC_QUEUE_H_
+#define MIMIXFE_EXAMPLES_SPSC_QUEUE_H_
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <type_traits>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @enum OverflowPolicy
+ * @brief キューが満杯のときに push() された要素の扱い
+ */
+enum class OverflowPolicy
+{
+	DropOldest, //!< 最も古い未取得要素を破棄して新しい要素を格納する
+	DropNewest, //!< 新しい要素を破棄する
+	Block,      //!< 空きができるまで生産者側を待機させる（録音スレッドが停止し得るので注意）
+};
+
+/**
+ * @class SPSCQueue
+ * @brief recorderCallback_t が呼ばれるスレッド（生産者）と、ユーザー側の処理スレッド（消費者）の間で要素を受け渡す固定長キュー
+ * @details push() は 1 つのスレッドから、pop() は別の 1 つのスレッドからのみ呼び出すこと。DropNewest, DropOldest ではロックも待機も行わないため、
+ * 消費者側の処理が遅延しても libmimixfe の信号処理スレッドは停止しない。
+ * 各要素は格納位置ごとの通し番号で管理され、要素の読み書きは、その位置を取得した 1 つのスレッドのみが行う。DropOldest で生産者が最も古い要素を破棄する場合も、
+ * 消費者と同じく取り出し位置を CAS で取得してから上書きするので、消費者が読み出し中の要素が上書きされることはない。
+ * 満杯かつ最も古い要素を消費者が読み出し中の場合、DropOldest でも生産者は待たずに新しい要素を破棄する。
+ * pushed(), dropped() の単位は要素数である。
+ */
+template<typename T>
+class SPSCQueue
+{
+	static_assert(std::is_trivially_copyable<T>::value, "SPSCQueue requires a trivially copyable element type");
+public:
+	/**
+	 * @brief コンストラクタ
+	 * @param [in] capacity 最大要素数（2 以上の 2 のべき乗に切り上げられる。通し番号で空きと格納済を区別するため、最小値は 2 である）
+	 * @param [in] policy 満杯時の扱い
+	 */
+	explicit SPSCQueue(size_t capacity, OverflowPolicy policy = OverflowPolicy::DropOldest) :
+		policy_(policy), head_(0), tail_(0), pushed_(0), dropped_(0), closed_(false)
+	{
+		size_t n = 2;
+		while(n < capacity){
+			n <<= 1;
+		}
+		slots_ = std::vector<Slot>(n);
+		for(size_t i=0;i<n;++i){
+			slots_[i].sequence_.store(i, std::memory_order_relaxed);
+		}
+		mask_ = n-1;
+	}
+
+	/**
+	 * @brief 要素を追加する（生産者スレッド専用）
+	 * @param [in] item 追加する要素
+	 * @return 要素が格納された場合 true、新しい要素が破棄された場合もしくは close() 済の場合 false
+	 */
+	bool push(const T& item)
+	{
+		const size_t tail = tail_.load(std::memory_order_relaxed);
+		Slot& slot = slots_[tail & mask_];
+		for(;;){
+			// 空いている位置の通し番号は tail と等しい
+			if(slot.sequence_.load(std::memory_order_acquire) == tail){
+				break;
+			}
+			if(policy_ == OverflowPolicy::DropOldest){
+				// 満杯の場合、この位置は最も古い要素 (tail - 容量) である。取り出し位置を取得できれば、その要素を破棄して上書きする
+				size_t head = tail - (mask_+1);
+				if(head_.compare_exchange_strong(head, head+1, std::memory_order_acq_rel)){
+					dropped_.fetch_add(1, std::memory_order_relaxed);
+					break;
+				}
+				if(slot.sequence_.load(std::memory_order_acquire) == tail){
+					break; // 消費者が取り出し終えた
+				}
+				// 消費者が読み出し中のため、待たずに新しい要素を破棄する
+				dropped_.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}else if(policy_ == OverflowPolicy::DropNewest){
+				dropped_.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}else{
+				if(closed_.load(std::memory_order_acquire)){
+					return false;
+				}
+				std::this_thread::yield();
+			}
+		}
+		slot.value_ = item;
+		slot.sequence_.store(tail+1, std::memory_order_release);
+		tail_.store(tail+1, std::memory_order_release);
+		pushed_.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	/**
+	 * @brief 要素を取り出す（消費者スレッド専用）
+	 * @param [out] item 取り出された要素
+	 * @return 要素を取り出せた場合 true、キューが空の場合 false
+	 */
+	bool pop(T& item)
+	{
+		size_t head = head_.load(std::memory_order_acquire);
+		for(;;){
+			Slot& slot = slots_[head & mask_];
+			const size_t sequence = slot.sequence_.load(std::memory_order_acquire);
+			if(sequence == head+1){
+				// 取り出し位置を取得してから読み出す。失敗した場合は生産者が DropOldest で破棄したので、更新された head で読み直す
+				if(head_.compare_exchange_strong(head, head+1, std::memory_order_acq_rel)){
+					item = slot.value_;
+					slot.sequence_.store(head + mask_ + 1, std::memory_order_release);
+					return true;
+				}
+			}else if(sequence == head){
+				return false; // 空
+			}else{
+				head = head_.load(std::memory_order_acquire); // 生産者が破棄して上書きした
+			}
+		}
+	}
+
+	/**
+	 * @brief 要素を取り出す。キューが空の場合は要素が追加されるか close() されるか timeout が経過するまで待機する（消費者スレッド専用）
+	 * @param [out] item 取り出された要素
+	 * @param [in] timeout 最大待機時間
+	 * @return 要素を取り出せた場合 true
+	 */
+	bool pop(T& item, std::chrono::milliseconds timeout)
+	{
+		const auto deadline = std::chrono::steady_clock::now() + timeout;
+		while(!pop(item)){
+			if(closed_.load(std::memory_order_acquire) || std::chrono::steady_clock::now() >= deadline){
+				return false;
+			}
+			// 生産者側を待機させないよう、条件変数ではなく短い間隔のポーリングで待つ
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return true;
+	}
+
+	/**
+	 * @brief キューを閉じる。Block で待機中の生産者、及び待機中の消費者を解放する。
+	 */
+	void close() { closed_.store(true, std::memory_order_release); }
+	bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+	size_t capacity() const { return mask_+1; }
+	size_t size() const
+	{
+		const size_t head = head_.load(std::memory_order_acquire);
+		const size_t tail = tail_.load(std::memory_order_acquire);
+		return tail > head ? tail - head : 0;
+	}
+	uint64_t pushed() const { return pushed_.load(std::memory_order_relaxed); }   //!< 格納された要素数の累計
+	uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); } //!< 溢れにより破棄された要素数の累計
+
+private:
+	/**
+	 * @class Slot
+	 * @brief 要素と通し番号。通し番号が位置 n と等しければ空き、n+1 であれば要素 n が格納済である。
+	 */
+	class Slot
+	{
+	public:
+		Slot() : sequence_(0) {}
+		std::atomic<size_t> sequence_;
+		T value_;
+	};
+
+	SPSCQueue(const SPSCQueue&) = delete;
+	SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+	const OverflowPolicy policy_;
+	std::vector<Slot> slots_;
+	size_t mask_;
+	std::atomic<size_t> head_; //!< 次に取り出す位置（DropOldest では生産者も進める）
+	char padding_[64];         //!< head_ と tail_ が同じキャッシュラインに載らないようにする
+	std::atomic<size_t> tail_; //!< 次に格納する位置
+	std::atomic<uint64_t> pushed_;
+	std::atomic<uint64_t> dropped_;
+	std::atomic<bool> closed_;
+};
+
+#endif /* MIMIXFE_EXAMPLES_SPSC_QUEUE_H_ */
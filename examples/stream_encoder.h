@@ -0,0 +1,214 @@
+/*
+ * @file stream_encoder.h
+ * \~english
+ * @brief Base class of streaming audio encoders running on a worker thread
+ * \~japanese
+ * @brief ワーカースレッドで動作するストリーミング音声エンコーダの基底クラス
+ * \~
+ * @copyright Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ * @copyright Apache License, Version 2.0
+ *
+ * Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MIMIXFE_EXAMPLES_STREAM_ENCODER_H_
+#define MIMIXFE_EXAMPLES_STREAM_ENCODER_H_
+
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "spsc_queue.h"
+
+/**
+ * @brief 圧縮済音声を受け取るコールバック関数
+ * @param [in] data 圧縮済音声
+ * @param [in] len data のバイト数
+ * @param [in] streamId beginStream() ごとに 1 ずつ増える番号
+ * @param [in] userdata 任意データ
+ */
+using encodedCallback_t = void (*)(
+		const unsigned char* data,
+		size_t len,
+		int streamId,
+		void* userdata);
+
+/**
+ * @class StreamEncoder
+ * @brief recorderCallback_t もしくは monitoringCallback_t で得た 16bit PCM を、ワーカースレッドで逐次圧縮する
+ * @details beginStream(), write(), endStream() はコールバック関数のスレッドから呼び出す。これらはコピーしてキューに積むのみで、圧縮処理と encodedCallback_t の呼び出しは
+ * ワーカースレッドで行われるため、圧縮処理によって libmimixfe の信号処理が遅延することはない。
+ * 圧縮処理に失敗した場合、そのストリームの残りの音声は破棄され、破棄された要素数が errors() に数えられる。ストリームの終了処理の失敗は closeErrors() に別に数えられる。
+ * 派生クラスは、コンストラクタの最後で startWorker() を、デストラクタの最初で stopWorker() を呼び出すこと。
+ */
+class StreamEncoder
+{
+public:
+	virtual ~StreamEncoder(){ stopWorker(); }
+
+	/**
+	 * @brief 新しいストリームを開始する。前のストリームが終了していない場合は終了させる。
+	 * @return キューが溢れて破棄された場合 false
+	 */
+	bool beginStream() { return pushControl(Chunk::Begin); }
+
+	/**
+	 * @brief ストリームを終了する。未出力のサンプルが圧縮され、出力される。
+	 * @return キューが溢れて破棄された場合 false
+	 */
+	bool endStream() { return pushControl(Chunk::End); }
+
+	/**
+	 * @brief 音声を追加する。ストリームが開始されていない場合は自動的に開始される。
+	 * @param [in] buffer 16bit PCM 音声（複数チャネルの場合はインターリーブ）
+	 * @param [in] buflen buffer のサンプル数
+	 * @return 全ての音声がキューに積まれた場合 true、キューが溢れて一部が破棄された場合 false
+	 */
+	bool write(const short* buffer, size_t buflen)
+	{
+		bool ok = true;
+		for(size_t offset=0;offset<buflen;offset+=chunk_.len_){
+			chunk_.type_ = Chunk::Data;
+			chunk_.len_ = std::min(buflen - offset, static_cast<size_t>(Chunk::maxSamples_));
+			std::copy(buffer + offset, buffer + offset + chunk_.len_, chunk_.samples_);
+			ok = queue_.push(chunk_) && ok;
+		}
+		return ok;
+	}
+
+	uint64_t dropped() const { return queue_.dropped(); } //!< キューが溢れて破棄された要素数
+	uint64_t errors() const { return errors_.load(); }    //!< ストリームの開始や圧縮処理の失敗によって破棄された要素数
+	uint64_t closeErrors() const { return closeErrors_.load(); } //!< ストリームの終了処理（未出力サンプルの圧縮）に失敗した回数
+
+protected:
+	/**
+	 * @class Chunk
+	 * @brief キューの 1 要素
+	 */
+	class Chunk
+	{
+	public:
+		enum Type { Begin, Data, End };
+		static const size_t maxSamples_ = 1680; //!< 1 〜 8 チャネルのいずれでも割り切れる長さ
+		Type type_;
+		size_t len_;
+		short samples_[maxSamples_];
+	};
+
+	StreamEncoder(encodedCallback_t callback, void* userdata, unsigned channels) :
+		channels_(channels), callback_(callback), userdata_(userdata),
+		queue_(256, OverflowPolicy::DropNewest), streamId_(-1), nextStreamId_(0), opened_(false), failed_(false), errors_(0), closeErrors_(0) {}
+
+	void startWorker() { worker_ = std::thread(&StreamEncoder::run, this); }
+
+	/**
+	 * @brief キューに残っている音声を全て圧縮してからワーカースレッドを終了する
+	 */
+	void stopWorker()
+	{
+		if(worker_.joinable()){
+			queue_.close();
+			worker_.join();
+		}
+	}
+
+	/**
+	 * @brief 圧縮済音声を encodedCallback_t に与える（ワーカースレッド専用）
+	 */
+	void emit(const unsigned char* data, size_t len) { callback_(data, len, streamId_, userdata_); }
+
+	virtual bool openStream() = 0;                           //!< ストリームを開始する。失敗した場合 false
+	virtual bool closeStream() = 0;                          //!< 未出力のサンプルを圧縮して出力し、ストリームを終了する。圧縮に失敗した場合 false
+	virtual bool encode(const short* buffer, size_t len) = 0; //!< 音声を圧縮する。len はチャネル数の倍数。失敗した場合 false
+
+	const unsigned channels_;
+
+private:
+	StreamEncoder(const StreamEncoder&) = delete;
+	StreamEncoder& operator=(const StreamEncoder&) = delete;
+
+	bool pushControl(Chunk::Type type)
+	{
+		Chunk c;
+		c.type_ = type;
+		c.len_ = 0;
+		return queue_.push(c);
+	}
+
+	void open()
+	{
+		streamId_ = nextStreamId_++;
+		opened_ = openStream();
+		failed_ = !opened_;
+	}
+
+	void close()
+	{
+		if(opened_){
+			if(!closeStream()){
+				closeErrors_++;
+			}
+			opened_ = false;
+		}
+	}
+
+	void run()
+	{
+		Chunk c;
+		for(;;){
+			if(!queue_.pop(c, std::chrono::milliseconds(100))){
+				if(queue_.closed() && queue_.size() == 0){
+					break;
+				}
+				continue;
+			}
+			if(c.type_ == Chunk::Begin){
+				close();
+				open();
+			}else if(c.type_ == Chunk::End){
+				close();
+				failed_ = false;
+			}else{
+				if(!opened_ && !failed_){
+					open();
+				}
+				if(!opened_){
+					errors_++; // ストリームの開始に失敗している
+				}else if(!encode(c.samples_, c.len_)){
+					// 失敗したエンコーダでは続きを圧縮できないので、ストリームの終わりまで破棄する
+					errors_++;
+					close();
+					failed_ = true;
+				}
+			}
+		}
+		close();
+	}
+
+	const encodedCallback_t callback_;
+	void* const userdata_;
+	SPSCQueue<Chunk> queue_;
+	Chunk chunk_;       //!< write() 内で要素を組み立てるための作業領域
+	std::thread worker_;
+	int streamId_;      //!< 現在のストリームの番号（ワーカースレッドのみが参照する）
+	int nextStreamId_;
+	bool opened_;
+	bool failed_;       //!< 現在のストリームの開始もしくは圧縮処理に失敗したか
+	std::atomic<uint64_t> errors_;
+	std::atomic<uint64_t> closeErrors_;
+};
+
+#endif /* MIMIXFE_EXAMPLES_STREAM_ENCODER_H_ */
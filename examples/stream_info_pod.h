@@ -0,0 +1,87 @@
+/*
+ * @file stream_info_pod.h
+ * \~english
+ * @brief Trivially copyable, fixed-size copy of mimixfe::StreamInfo
+ * \~japanese
+ * @brief mimixfe::StreamInfo のトリビアルにコピー可能な固定長版
+ * \~
+ * @copyright Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ * @copyright Apache License, Version 2.0
+ *
+ * Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MIMIXFE_EXAMPLES_STREAM_INFO_POD_H_
+#define MIMIXFE_EXAMPLES_STREAM_INFO_POD_H_
+
+#include <algorithm>
+#include <type_traits>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "XFETypedef.h"
+
+/**
+ * @class StreamInfoPOD
+ * @brief StreamInfo と同じ内容を、動的メモリ確保なしで保持するデータクラス
+ * @details 空間スペクトルは固定長の配列に格納されるため、memcpy によるコピーや共有メモリへの書き込み、SPSCQueue への格納ができる。
+ * 空間スペクトルが maxSpatialSpectrumSize_ より長い場合は先頭から maxSpatialSpectrumSize_ 個のみ保持される。
+ */
+class StreamInfoPOD
+{
+public:
+	static const size_t maxSpatialSpectrumSize_ = 360; //!< 保持できる空間スペクトルの最大長（水平面 1 度刻み）
+
+	uint64_t milliseconds_;                //!< 経過時間[ms]
+	int32_t azimuth_;                      //!< 10msec フレームの推定方向の方位角
+	int32_t angle_;                        //!< 10msec フレームの推定方向の迎え角
+	int32_t utteranceAzimuth_;             //!< 発話単位での推定方向の方位角
+	int32_t utteranceAngle_;               //!< 発話単位での推定方向の迎え角
+	float speechProbability_;              //!< 10msec フレームの発話存在確率[0,1]
+	float rmsDbfs_;                        //!< 平均音量[dbfs]
+	int32_t numSoundSources_;              //!< 抽出された音源数
+	int32_t totalNumSoundSources_;         //!< 検出された音源数
+	float spatialSpectralPeak_;            //!< 空間スペクトル値[db]
+	uint32_t spatialSpectrumSize_;         //!< spatialSpectrum_ の有効な要素数
+	float spatialSpectrum_[maxSpatialSpectrumSize_]; //!< 平均空間スペクトル[db]
+
+	mimixfe::Direction direction() const { return mimixfe::Direction(azimuth_, angle_); }
+	mimixfe::Direction utteranceDirection() const { return mimixfe::Direction(utteranceAzimuth_, utteranceAngle_); }
+};
+
+static_assert(std::is_trivially_copyable<StreamInfoPOD>::value, "StreamInfoPOD must be trivially copyable");
+static_assert(std::is_standard_layout<StreamInfoPOD>::value, "StreamInfoPOD must have standard layout");
+
+/**
+ * @brief StreamInfo を StreamInfoPOD にコピーする。コピー先のメモリは確保済であるので、コールバック関数内で呼び出してもメモリ確保は発生しない。
+ * @param [in] src コピー元
+ * @param [out] dst コピー先
+ */
+inline void toStreamInfoPOD(const mimixfe::StreamInfo& src, StreamInfoPOD& dst)
+{
+	dst.milliseconds_ = src.milliseconds_;
+	dst.azimuth_ = src.direction_.azimuth_;
+	dst.angle_ = src.direction_.angle_;
+	dst.utteranceAzimuth_ = src.utteranceDirection_.azimuth_;
+	dst.utteranceAngle_ = src.utteranceDirection_.angle_;
+	dst.speechProbability_ = src.speechProbability_;
+	dst.rmsDbfs_ = src.rmsDbfs_;
+	dst.numSoundSources_ = src.numSoundSources_;
+	dst.totalNumSoundSources_ = src.totalNumSoundSources_;
+	dst.spatialSpectralPeak_ = src.spatialSpectralPeak_;
+	dst.spatialSpectrumSize_ = std::min(src.spatialSpectrum_.size(), static_cast<size_t>(StreamInfoPOD::maxSpatialSpectrumSize_));
+	std::copy(src.spatialSpectrum_.begin(), src.spatialSpectrum_.begin() + dst.spatialSpectrumSize_, dst.spatialSpectrum_);
+}
+
+#endif /* MIMIXFE_EXAMPLES_STREAM_INFO_POD_H_ */
@@ -0,0 +1,175 @@
+/*
+ * @file stream_stats.h
+ * \~english
+ * @brief Timing and real-time factor statistics observed at the recorder callback
+ * \~japanese
+ * @brief コールバック関数で観測される処理時間及び実時間比の統計
+ * \~
+ * @copyright Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ * @copyright Apache License, Version 2.0
+ *
+ * Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MIMIXFE_EXAMPLES_STREAM_STATS_H_
+#define MIMIXFE_EXAMPLES_STREAM_STATS_H_
+
+#include <atomic>
+#include <time.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "XFETypedef.h"
+
+/**
+ * @class StreamStats
+ * @brief recorderCallback_t の呼び出しを計測し、処理時間、実時間比、フレーム欠落を集計する
+ * @details 集計はコールバック関数のスレッドで行い、snapshot() は任意のスレッドから呼び出すことができる。集計中にロックは行わない。
+ * 実時間比（RTF）は、プロセス全体の CPU 時間をストリーム上の経過時間で割った値であり、1.0 を下回っていれば実時間以内で処理できている。
+ * 複数コアを利用する場合、RTF が 1.0 を上回っていても実時間で処理できていることがあるので、遅延（lagMs_）の増加傾向と合わせて判断する。
+ * ストリーム上の時間は StreamInfo の経過時間から求めるので、XFEOutputConfig::outputType::allFrames として非発話区間もコールバックさせること。
+ * audioFrames では非発話区間にストリーム上の時間が進まないため、RTF と遅延は過大になり、非発話区間が欠落フレームとして数えられる。
+ */
+class StreamStats
+{
+public:
+	/**
+	 * @class Snapshot
+	 * @brief ある時点での集計結果
+	 */
+	class Snapshot
+	{
+	public:
+		uint64_t callbacks_;        //!< コールバック関数の呼び出し回数
+		double callbackTotalMs_;    //!< コールバック関数の処理時間の累計[ms]
+		double callbackRecentMs_;   //!< コールバック関数の処理時間の直近の平均（指数移動平均）[ms]
+		double callbackMaxMs_;      //!< コールバック関数の処理時間の最大値[ms]
+		uint64_t streamMs_;         //!< 最初のコールバック以降に進んだストリーム上の時間[ms]（StreamInfo の経過時間から求める。XFEOutputConfig::outputType::allFrames の場合のみ有効）
+		double wallMs_;             //!< 最初のコールバック以降の経過時間[ms]
+		double cpuMs_;              //!< 最初のコールバック以降のプロセスの CPU 時間[ms]
+		double realTimeFactor_;     //!< cpuMs_ / streamMs_（XFEOutputConfig::outputType::allFrames の場合のみ有効）
+		double lagMs_;              //!< wallMs_ - streamMs_。増加し続ける場合、信号処理が実時間に追いついていない（XFEOutputConfig::outputType::allFrames の場合のみ有効）
+		uint64_t missingFrames_;    //!< StreamInfo の経過時間の不連続から推定した欠落フレーム数（XFEOutputConfig::outputType::allFrames の場合のみ有効）
+	};
+
+	/**
+	 * @class Timer
+	 * @brief コールバック関数の先頭で構築し、スコープを抜けるまでの時間を計測する
+	 */
+	class Timer
+	{
+	public:
+		Timer(StreamStats& stats, const mimixfe::StreamInfo* info, size_t infolen) :
+			stats_(stats), start_(monotonicNs())
+		{
+			stats_.onFrames(info, infolen, start_);
+		}
+		~Timer(){ stats_.onCallbackEnd(monotonicNs() - start_); }
+	private:
+		StreamStats& stats_;
+		const int64_t start_;
+	};
+
+	StreamStats() :
+		callbacks_(0), callbackNs_(0), callbackRecentNs_(0), callbackMaxNs_(0),
+		firstWallNs_(0), firstCpuNs_(0), firstStreamMs_(0), lastStreamMs_(0), missingFrames_(0) {}
+
+	/**
+	 * @brief 集計結果を取得する
+	 */
+	Snapshot snapshot() const
+	{
+		Snapshot s;
+		s.callbacks_ = callbacks_.load(std::memory_order_relaxed);
+		s.callbackTotalMs_ = callbackNs_.load(std::memory_order_relaxed) / 1e6;
+		s.callbackRecentMs_ = callbackRecentNs_.load(std::memory_order_relaxed) / 1e6;
+		s.callbackMaxMs_ = callbackMaxNs_.load(std::memory_order_relaxed) / 1e6;
+		s.missingFrames_ = missingFrames_.load(std::memory_order_relaxed);
+		const int64_t firstWall = firstWallNs_.load(std::memory_order_acquire);
+		if(firstWall == 0){
+			s.streamMs_ = 0;
+			s.wallMs_ = s.cpuMs_ = s.realTimeFactor_ = s.lagMs_ = 0;
+			return s;
+		}
+		s.streamMs_ = lastStreamMs_.load(std::memory_order_relaxed) - firstStreamMs_.load(std::memory_order_relaxed);
+		s.wallMs_ = (monotonicNs() - firstWall) / 1e6;
+		s.cpuMs_ = (processCpuNs() - firstCpuNs_.load(std::memory_order_relaxed)) / 1e6;
+		s.realTimeFactor_ = s.streamMs_ == 0 ? 0 : s.cpuMs_ / s.streamMs_;
+		s.lagMs_ = s.wallMs_ - s.streamMs_;
+		return s;
+	}
+
+private:
+	static const int64_t frameMs_ = 10; //!< StreamInfo 1 つあたりの長さ[ms]
+
+	static int64_t monotonicNs()
+	{
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+	}
+
+	static int64_t processCpuNs()
+	{
+		struct timespec ts;
+		clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+		return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+	}
+
+	void onFrames(const mimixfe::StreamInfo* info, size_t infolen, int64_t now)
+	{
+		if(infolen == 0){
+			return;
+		}
+		const uint64_t first = info[0].milliseconds_;
+		const uint64_t last = info[infolen-1].milliseconds_ + frameMs_;
+		if(firstWallNs_.load(std::memory_order_relaxed) == 0){
+			firstStreamMs_.store(first, std::memory_order_relaxed);
+			lastStreamMs_.store(first, std::memory_order_relaxed);
+			firstCpuNs_.store(processCpuNs(), std::memory_order_relaxed);
+			firstWallNs_.store(now, std::memory_order_release);
+		}
+		// 複数音源の場合は同じ時刻のフレームが音源ごとに与えられるので、時刻が進んだ場合のみ扱う
+		const uint64_t prev = lastStreamMs_.load(std::memory_order_relaxed);
+		if(last > prev){
+			if(first > prev){
+				missingFrames_.fetch_add((first - prev) / frameMs_, std::memory_order_relaxed);
+			}
+			lastStreamMs_.store(last, std::memory_order_relaxed);
+		}
+	}
+
+	void onCallbackEnd(int64_t elapsedNs)
+	{
+		callbacks_.fetch_add(1, std::memory_order_relaxed);
+		callbackNs_.fetch_add(elapsedNs, std::memory_order_relaxed);
+		const int64_t recent = callbackRecentNs_.load(std::memory_order_relaxed);
+		callbackRecentNs_.store(recent == 0 ? elapsedNs : recent + (elapsedNs - recent) / 16, std::memory_order_relaxed);
+		if(elapsedNs > callbackMaxNs_.load(std::memory_order_relaxed)){
+			callbackMaxNs_.store(elapsedNs, std::memory_order_relaxed);
+		}
+	}
+
+	std::atomic<uint64_t> callbacks_;
+	std::atomic<int64_t> callbackNs_;
+	std::atomic<int64_t> callbackRecentNs_;
+	std::atomic<int64_t> callbackMaxNs_;
+	std::atomic<int64_t> firstWallNs_;
+	std::atomic<int64_t> firstCpuNs_;
+	std::atomic<uint64_t> firstStreamMs_;
+	std::atomic<uint64_t> lastStreamMs_;
+	std::atomic<uint64_t> missingFrames_;
+};
+
+#endif /* MIMIXFE_EXAMPLES_STREAM_STATS_H_ */
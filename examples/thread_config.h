@@ -0,0 +1,198 @@
+/*
+ * @file thread_config.h
+ * \~english
+ * @brief CPU affinity and real-time scheduling for libmimixfe threads and callback threads
+ * \~japanese
+ * @brief libmimixfe のスレッド及びコールバック関数を呼び出すスレッドの CPU 割り当てとリアルタイムスケジューリングの設定
+ * \~
+ * @copyright Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ * @copyright Apache License, Version 2.0
+ *
+ * Copyright 2026 Fairy Devices Inc. http://www.fairydevices.jp/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MIMIXFE_EXAMPLES_THREAD_CONFIG_H_
+#define MIMIXFE_EXAMPLES_THREAD_CONFIG_H_
+
+#include <vector>
+#include <atomic>
+#include <pthread.h>
+#include <sched.h>
+
+/**
+ * @class ThreadConfig
+ * @brief スレッドの CPU 割り当てとスケジューリングポリシー
+ */
+class ThreadConfig
+{
+public:
+	std::vector<int> cpus_;    //!< 割り当てる CPU 番号。空の場合は変更しない
+	int policy_ = SCHED_OTHER; //!< スケジューリングポリシー（SCHED_OTHER, SCHED_FIFO, SCHED_RR）
+	int priority_ = 0;         //!< 優先度。SCHED_FIFO, SCHED_RR の場合 1 〜 99
+	bool changeScheduling_ = false; //!< スケジューリングポリシーと優先度を変更するか
+};
+
+/**
+ * @class ThreadConfigResult
+ * @brief ThreadConfig の適用結果。エラー番号は pthread_setaffinity_np(), pthread_setschedparam() の戻り値であり、権限がない場合は EPERM となる。
+ */
+class ThreadConfigResult
+{
+public:
+	static const int notRequested_ = -1; //!< 変更を要求していない
+
+	int affinityError_ = notRequested_;   //!< CPU 割り当ての結果。成功した場合 0
+	int schedulingError_ = notRequested_; //!< スケジューリングポリシーと優先度の結果。成功した場合 0
+
+	/**
+	 * @brief 要求した全ての変更が適用されたか
+	 */
+	bool honored() const
+	{
+		return (affinityError_ == 0 || affinityError_ == notRequested_) && (schedulingError_ == 0 || schedulingError_ == notRequested_);
+	}
+};
+
+/**
+ * @brief 呼び出したスレッドに ThreadConfig を適用する
+ */
+inline ThreadConfigResult applyThreadConfig(const ThreadConfig& config)
+{
+	ThreadConfigResult result;
+	pthread_t self = pthread_self();
+	if(!config.cpus_.empty()){
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		for(int cpu : config.cpus_){
+			CPU_SET(cpu, &set);
+		}
+		result.affinityError_ = pthread_setaffinity_np(self, sizeof(set), &set);
+	}
+	if(config.changeScheduling_){
+		sched_param param;
+		param.sched_priority = config.priority_;
+		result.schedulingError_ = pthread_setschedparam(self, config.policy_, &param);
+	}
+	return result;
+}
+
+/**
+ * @class ScopedThreadConfig
+ * @brief 呼び出したスレッドに ThreadConfig を一時的に適用し、restore() もしくはデストラクタで元に戻す
+ * @details Linux では、新しく生成されたスレッドは生成したスレッドの CPU 割り当てとスケジューリングポリシーを引き継ぐ。
+ * XFERecorder の生成から XFERecorder::start() までをこのスコープで囲むと、その間に libmimixfe が生成する録音・信号処理スレッドに設定が適用され、
+ * 呼び出し元のスレッド（ネットワーククライアント等）は元の設定に戻る。
+ */
+class ScopedThreadConfig
+{
+public:
+	explicit ScopedThreadConfig(const ThreadConfig& config) : restored_(false)
+	{
+		pthread_t self = pthread_self();
+		affinitySaved_ = pthread_getaffinity_np(self, sizeof(affinity_), &affinity_) == 0;
+		schedulingSaved_ = pthread_getschedparam(self, &policy_, &param_) == 0;
+		result_ = applyThreadConfig(config);
+	}
+
+	~ScopedThreadConfig(){ restore(); }
+
+	/**
+	 * @brief 呼び出したスレッドの設定を元に戻す
+	 */
+	void restore()
+	{
+		if(restored_){
+			return;
+		}
+		restored_ = true;
+		pthread_t self = pthread_self();
+		if(result_.affinityError_ == 0 && affinitySaved_){
+			pthread_setaffinity_np(self, sizeof(affinity_), &affinity_);
+		}
+		if(result_.schedulingError_ == 0 && schedulingSaved_){
+			pthread_setschedparam(self, policy_, &param_);
+		}
+	}
+
+	/**
+	 * @brief 適用結果
+	 */
+	const ThreadConfigResult& result() const { return result_; }
+
+private:
+	ScopedThreadConfig(const ScopedThreadConfig&) = delete;
+	ScopedThreadConfig& operator=(const ScopedThreadConfig&) = delete;
+
+	ThreadConfigResult result_;
+	bool restored_;
+	bool affinitySaved_;
+	bool schedulingSaved_;
+	cpu_set_t affinity_;
+	int policy_;
+	sched_param param_;
+};
+
+/**
+ * @class CallbackThreadConfig
+ * @brief コールバック関数の中から apply() を呼び出し、コールバック関数を呼び出しているスレッドに ThreadConfig を 1 回だけ適用する
+ * @details 適用結果は任意のスレッドから result() で取得できる。適用前は applied() が false となる。
+ */
+class CallbackThreadConfig
+{
+public:
+	explicit CallbackThreadConfig(const ThreadConfig& config) : config_(config), applied_(false), affinityError_(0), schedulingError_(0) {}
+
+	/**
+	 * @brief 初回の呼び出しでのみ、呼び出したスレッドに設定を適用する。2 回目以降は何もしない。
+	 */
+	void apply()
+	{
+		if(applied_.load(std::memory_order_acquire)){
+			return;
+		}
+		const ThreadConfigResult result = applyThreadConfig(config_);
+		affinityError_.store(result.affinityError_, std::memory_order_relaxed);
+		schedulingError_.store(result.schedulingError_, std::memory_order_relaxed);
+		applied_.store(true, std::memory_order_release);
+	}
+
+	/**
+	 * @brief 設定が適用済であるか
+	 */
+	bool applied() const { return applied_.load(std::memory_order_acquire); }
+
+	/**
+	 * @brief 適用結果。applied() が false の場合は意味を持たない。
+	 */
+	ThreadConfigResult result() const
+	{
+		ThreadConfigResult result;
+		if(applied()){
+			result.affinityError_ = affinityError_.load(std::memory_order_relaxed);
+			result.schedulingError_ = schedulingError_.load(std::memory_order_relaxed);
+		}
+		return result;
+	}
+
+private:
+	CallbackThreadConfig(const CallbackThreadConfig&) = delete;
+	CallbackThreadConfig& operator=(const CallbackThreadConfig&) = delete;
+
+	const ThreadConfig config_;
+	std::atomic<bool> applied_;
+	std::atomic<int> affinityError_;
+	std::atomic<int> schedulingError_;
+};
+
+#endif /* MIMIXFE_EXAMPLES_THREAD_CONFIG_H_ */